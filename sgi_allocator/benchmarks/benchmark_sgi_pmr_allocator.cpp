@@ -1,8 +1,21 @@
 #include <benchmark/benchmark.h>
 #include "../include/sgi_pmr_allocator.hpp"
+#include "../include/sgi_pmr_object_pool.hpp"
+#include "../include/sgi_pmr_page_map.hpp"
+#include "../include/sgi_pmr_profiler.hpp"
+#include "perf_counters.hpp"
+#include "size_distribution.hpp"
 #include <memory_resource>
 #include <vector>
 #include <random>
+#include <list>
+#include <map>
+#include <memory>
+#include <cstring>
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <unistd.h>
 
 using namespace sgi_pmr;
 
@@ -10,7 +23,7 @@ using namespace sgi_pmr;
 static void BM_SynchronizedPoolResource_SmallAllocations(benchmark::State& state) {
     synchronized_pool_resource mr;
     
-    for (auto _ : state) {
+    for (auto _ : perf::counted(state)) {
         std::vector<void*> pointers;
         pointers.reserve(state.range(0));
         
@@ -33,7 +46,7 @@ BENCHMARK(BM_SynchronizedPoolResource_SmallAllocations)->Arg(100)->Arg(1000)->Ar
 static void BM_UnsynchronizedPoolResource_SmallAllocations(benchmark::State& state) {
     unsynchronized_pool_resource mr;
     
-    for (auto _ : state) {
+    for (auto _ : perf::counted(state)) {
         std::vector<void*> pointers;
         pointers.reserve(state.range(0));
         
@@ -56,7 +69,7 @@ BENCHMARK(BM_UnsynchronizedPoolResource_SmallAllocations)->Arg(100)->Arg(1000)->
 static void BM_StdSynchronizedPoolResource_SmallAllocations(benchmark::State& state) {
     std::pmr::synchronized_pool_resource mr;
     
-    for (auto _ : state) {
+    for (auto _ : perf::counted(state)) {
         std::vector<void*> pointers;
         pointers.reserve(state.range(0));
         
@@ -79,7 +92,7 @@ BENCHMARK(BM_StdSynchronizedPoolResource_SmallAllocations)->Arg(100)->Arg(1000)-
 static void BM_StdUnsynchronizedPoolResource_SmallAllocations(benchmark::State& state) {
     std::pmr::unsynchronized_pool_resource mr;
     
-    for (auto _ : state) {
+    for (auto _ : perf::counted(state)) {
         std::vector<void*> pointers;
         pointers.reserve(state.range(0));
         
@@ -102,7 +115,7 @@ BENCHMARK(BM_StdUnsynchronizedPoolResource_SmallAllocations)->Arg(100)->Arg(1000
 static void BM_DefaultMemoryResource_SmallAllocations(benchmark::State& state) {
     std::pmr::memory_resource* mr = std::pmr::get_default_resource();
     
-    for (auto _ : state) {
+    for (auto _ : perf::counted(state)) {
         std::vector<void*> pointers;
         pointers.reserve(state.range(0));
         
@@ -128,7 +141,7 @@ static void BM_SynchronizedPoolResource_MixedAllocations(benchmark::State& state
     std::uniform_int_distribution<std::size_t> size_dist(8, 256);
     std::uniform_int_distribution<std::size_t> align_dist(1, 3);
     
-    for (auto _ : state) {
+    for (auto _ : perf::counted(state)) {
         std::vector<std::pair<void*, std::size_t>> allocations;
         allocations.reserve(state.range(0));
         
@@ -157,7 +170,7 @@ static void BM_UnsynchronizedPoolResource_MixedAllocations(benchmark::State& sta
     std::uniform_int_distribution<std::size_t> size_dist(8, 256);
     std::uniform_int_distribution<std::size_t> align_dist(1, 3);
     
-    for (auto _ : state) {
+    for (auto _ : perf::counted(state)) {
         std::vector<std::pair<void*, std::size_t>> allocations;
         allocations.reserve(state.range(0));
         
@@ -183,7 +196,7 @@ BENCHMARK(BM_UnsynchronizedPoolResource_MixedAllocations)->Arg(100)->Arg(1000)->
 static void BM_PolymorphicAllocatorVector_Synchronized(benchmark::State& state) {
     synchronized_pool_resource mr;
     
-    for (auto _ : state) {
+    for (auto _ : perf::counted(state)) {
         std::pmr::vector<int> vec(&mr);
         for (int i = 0; i < state.range(0); ++i) {
             vec.push_back(i);
@@ -199,7 +212,7 @@ BENCHMARK(BM_PolymorphicAllocatorVector_Synchronized)->Arg(100)->Arg(1000)->Arg(
 static void BM_PolymorphicAllocatorVector_Unsynchronized(benchmark::State& state) {
     unsynchronized_pool_resource mr;
     
-    for (auto _ : state) {
+    for (auto _ : perf::counted(state)) {
         std::pmr::vector<int> vec(&mr);
         for (int i = 0; i < state.range(0); ++i) {
             vec.push_back(i);
@@ -211,4 +224,480 @@ static void BM_PolymorphicAllocatorVector_Unsynchronized(benchmark::State& state
 }
 BENCHMARK(BM_PolymorphicAllocatorVector_Unsynchronized)->Arg(100)->Arg(1000)->Arg(10000);
 
+// 160~512 字节节点的基准测试：默认配置下这些大小直接走 malloc，
+// 扩大 max_bytes 并使用几何间隔后由空闲链表处理
+template <typename Resource>
+static void BM_MediumNodeAllocations(benchmark::State& state) {
+    Resource mr;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> size_dist(160, 512);
+
+    for (auto _ : perf::counted(state)) {
+        std::vector<std::pair<void*, std::size_t>> allocations;
+        allocations.reserve(state.range(0));
+
+        for (int i = 0; i < state.range(0); ++i) {
+            std::size_t size = size_dist(rng);
+            void* ptr = mr.allocate(size, 8);
+            benchmark::DoNotOptimize(ptr);
+            allocations.emplace_back(ptr, size);
+        }
+
+        for (const auto& alloc : allocations) {
+            mr.deallocate(alloc.first, alloc.second, 8);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using geometric_512_pool_resource = basic_unsynchronized_pool_resource<
+    pool_options{.max_bytes = 512, .spacing = size_class_spacing::geometric}>;
+
+BENCHMARK_TEMPLATE(BM_MediumNodeAllocations, unsynchronized_pool_resource)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_MediumNodeAllocations, geometric_512_pool_resource)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_MediumNodeAllocations, std::pmr::unsynchronized_pool_resource)->Arg(1000)->Arg(10000);
+
+// 8 字节到 range(1) 字节的混合大小基准测试：大小按对数均匀分布，每轮分配 range(0) 个对象后按随机顺序释放。
+// 默认配置下超过 128 字节的请求交给上游，启用中等对象层后 32KB 以内都由空闲链表处理
+template <typename Resource>
+static void BM_MixedSizeRange(benchmark::State& state) {
+    Resource mr;
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+    const std::size_t max_bytes = static_cast<std::size_t>(state.range(1));
+    std::mt19937 rng(42);
+
+    std::vector<std::size_t> sizes(count);
+    for (std::size_t& size : sizes) {
+        size = perf::random_size(rng, max_bytes);
+    }
+    std::vector<std::size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<void*> pointers(count);
+
+    for (auto _ : perf::counted(state)) {
+        for (std::size_t i = 0; i < count; ++i) {
+            pointers[i] = mr.allocate(sizes[i], 8);
+            benchmark::DoNotOptimize(pointers[i]);
+        }
+        for (std::size_t i : order) {
+            mr.deallocate(pointers[i], sizes[i], 8);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+#define SGI_MIXED_SIZE_BENCHMARK(Resource) \
+    BENCHMARK_TEMPLATE(BM_MixedSizeRange, Resource)->ArgNames({"count", "max"})->ArgsProduct({{1000, 10000}, {256, 4096, 32768}})
+
+SGI_MIXED_SIZE_BENCHMARK(unsynchronized_pool_resource);
+SGI_MIXED_SIZE_BENCHMARK(medium_unsynchronized_pool_resource);
+SGI_MIXED_SIZE_BENCHMARK(synchronized_pool_resource);
+SGI_MIXED_SIZE_BENCHMARK(medium_synchronized_pool_resource);
+SGI_MIXED_SIZE_BENCHMARK(std::pmr::unsynchronized_pool_resource);
+SGI_MIXED_SIZE_BENCHMARK(std::pmr::synchronized_pool_resource);
+
+namespace {
+
+struct alignas(32) simd_lanes {
+    float lanes[8];
+};
+
+struct alignas(64) padded_counter {
+    long value;
+};
+
+} // namespace
+
+// 过对齐对象的容器基准测试：alignas(32)/alignas(64) 元素的 pmr::list 反复插入和清空
+template <typename Resource, typename T>
+static void BM_OverAlignedList(benchmark::State& state) {
+    Resource mr;
+
+    for (auto _ : perf::counted(state)) {
+        std::pmr::list<T> nodes(&mr);
+        for (int i = 0; i < state.range(0); ++i) {
+            nodes.emplace_back();
+        }
+        benchmark::DoNotOptimize(&nodes.back());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_OverAlignedList, unsynchronized_pool_resource, simd_lanes)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_OverAlignedList, unsynchronized_pool_resource, padded_counter)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_OverAlignedList, synchronized_pool_resource, padded_counter)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_OverAlignedList, std::pmr::unsynchronized_pool_resource, padded_counter)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_OverAlignedList, std::pmr::synchronized_pool_resource, padded_counter)->Arg(1000)->Arg(10000);
+
+namespace {
+
+// 统计上游调用次数的内存资源，用于比较 std::pmr 池的上游开销
+class counting_resource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+// 内存池 refill 的基准测试：每次迭代使用新的内存池分配 state.range(0) 个 8~128 字节对象，
+// upstream_calls 为每次迭代向系统申请内存块的次数
+static void BM_SGIPoolBase_RefillUpstreamCalls(benchmark::State& state) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> size_dist(8, 128);
+    std::size_t upstream_calls = 0;
+
+    for (auto _ : perf::counted(state)) {
+        sgi_pool_resource_base pool;
+        for (int i = 0; i < state.range(0); ++i) {
+            void* ptr = pool.allocate_impl(size_dist(rng), 8);
+            benchmark::DoNotOptimize(ptr);
+        }
+        upstream_calls += pool.chunk_count();
+    }
+
+    state.counters["upstream_calls"] = benchmark::Counter(
+        static_cast<double>(upstream_calls), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SGIPoolBase_RefillUpstreamCalls)->Arg(100)->Arg(1000)->Arg(10000);
+
+// std::pmr::unsynchronized_pool_resource 的同一负载，作为上游调用次数的对照
+static void BM_StdUnsynchronizedPoolResource_RefillUpstreamCalls(benchmark::State& state) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> size_dist(8, 128);
+    std::size_t upstream_calls = 0;
+
+    for (auto _ : perf::counted(state)) {
+        counting_resource upstream;
+        {
+            std::pmr::unsynchronized_pool_resource pool(&upstream);
+            for (int i = 0; i < state.range(0); ++i) {
+                void* ptr = pool.allocate(size_dist(rng), 8);
+                benchmark::DoNotOptimize(ptr);
+            }
+        }
+        upstream_calls += upstream.allocations;
+    }
+
+    state.counters["upstream_calls"] = benchmark::Counter(
+        static_cast<double>(upstream_calls), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdUnsynchronizedPoolResource_RefillUpstreamCalls)->Arg(100)->Arg(1000)->Arg(10000);
+
+// refill 批量的基准测试：每次迭代使用新的内存池，热点大小类（32 字节）分配 state.range(0) 个对象，
+// 其余每个大小类只分配一个对象；refills 为每次迭代的 refill 次数，held_kb 为持有的内存块大小
+template <pool_options Options>
+static void BM_RefillBatch(benchmark::State& state) {
+    std::size_t refills = 0;
+    std::size_t held_bytes = 0;
+    std::vector<void*> hot(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        basic_sgi_pool_resource_base<Options> pool;
+        for (auto& p : hot) {
+            p = pool.allocate_impl(32, 8);
+        }
+        for (std::size_t bytes = 8; bytes <= 128; bytes += 8) {
+            if (bytes != 32) {
+                benchmark::DoNotOptimize(pool.allocate_impl(bytes, 8));
+            }
+        }
+        benchmark::DoNotOptimize(hot.data());
+
+        perf::pause(state);
+        pool_stats stats = pool.stats();
+        for (const size_class_stats& c : stats.size_classes) {
+            refills += c.refills;
+        }
+        held_bytes += stats.held_bytes;
+        perf::resume(state);
+    }
+
+    state.counters["refills"] = benchmark::Counter(static_cast<double>(refills), benchmark::Counter::kAvgIterations);
+    state.counters["held_kb"] = benchmark::Counter(static_cast<double>(held_bytes) / 1024,
+                                                   benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+constexpr pool_options fixed_batch_20{.enable_stats = true};
+constexpr pool_options fixed_batch_256{.refill_batch = 256, .enable_stats = true};
+constexpr pool_options adaptive_batch_4_to_256{
+    .refill_batch = 4,
+    .min_refill_batch = 2,
+    .max_refill_batch = 256,
+    .enable_stats = true,
+};
+
+BENCHMARK_TEMPLATE(BM_RefillBatch, fixed_batch_20)->Arg(100)->Arg(10000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_RefillBatch, fixed_batch_256)->Arg(100)->Arg(10000)->Arg(100000);
+BENCHMARK_TEMPLATE(BM_RefillBatch, adaptive_batch_4_to_256)->Arg(100)->Arg(10000)->Arg(100000);
+
+// 统计开销的基准测试：同一负载下比较关闭和开启 enable_stats 的资源
+template <typename Resource>
+static void BM_StatsOverhead(benchmark::State& state) {
+    Resource mr;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> size_dist(8, 128);
+    std::vector<std::pair<void*, std::size_t>> allocations(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        for (auto& alloc : allocations) {
+            alloc.second = size_dist(rng);
+            alloc.first = mr.allocate(alloc.second, 8);
+            benchmark::DoNotOptimize(alloc.first);
+        }
+
+        for (const auto& alloc : allocations) {
+            mr.deallocate(alloc.first, alloc.second, 8);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using stats_unsynchronized_pool_resource = basic_unsynchronized_pool_resource<pool_options{.enable_stats = true}>;
+using stats_synchronized_pool_resource = basic_synchronized_pool_resource<pool_options{.enable_stats = true}>;
+
+BENCHMARK_TEMPLATE(BM_StatsOverhead, unsynchronized_pool_resource)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_StatsOverhead, stats_unsynchronized_pool_resource)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_StatsOverhead, synchronized_pool_resource)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_StatsOverhead, stats_synchronized_pool_resource)->Arg(1000)->Arg(10000);
+
+// 堆采样开销的基准测试：同一负载下比较不采样和平均每 512KB 采样一次的资源
+using sampled_unsynchronized_pool_resource =
+    basic_unsynchronized_pool_resource<pool_options{.sample_interval_bytes = 512 << 10}>;
+
+BENCHMARK_TEMPLATE(BM_StatsOverhead, sampled_unsynchronized_pool_resource)->Arg(1000)->Arg(10000);
+
+// 不带大小释放的基准测试：分配 state.range(0) 个 8~128 字节对象后全部释放，
+// 比较现有的带大小释放、按大小类划分内存块后的带大小释放和通过页映射查找大小类的释放
+enum class free_mode { sized, unsized };
+
+template <pool_options Options, free_mode Mode>
+static void BM_FreePath(benchmark::State& state) {
+    basic_unsynchronized_pool_resource<Options> mr;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> size_dist(8, 128);
+    std::vector<std::pair<void*, std::size_t>> allocations(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        for (auto& alloc : allocations) {
+            alloc.second = size_dist(rng);
+            alloc.first = mr.allocate(alloc.second, 8);
+        }
+        for (const auto& alloc : allocations) {
+            if constexpr (Mode == free_mode::sized) {
+                mr.deallocate(alloc.first, alloc.second, 8);
+            } else {
+                mr.deallocate_unsized(alloc.first);
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+constexpr pool_options span_pool{.size_class_spans = true};
+
+BENCHMARK_TEMPLATE(BM_FreePath, pool_options{}, free_mode::sized)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_FreePath, span_pool, free_mode::sized)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_FreePath, span_pool, free_mode::unsized)->Arg(1000)->Arg(10000);
+
+// 页映射查找的基准测试：对池化对象和不属于资源的对象调用 owns()
+static void BM_SpanOwnsLookup(benchmark::State& state) {
+    basic_unsynchronized_pool_resource<span_pool> mr;
+    std::vector<void*> pointers;
+    std::vector<std::unique_ptr<char[]>> foreign;
+    for (int i = 0; i < 1024; ++i) {
+        pointers.push_back(mr.allocate(8 + i % 128, 8));
+        foreign.emplace_back(new char[16]);
+    }
+
+    std::size_t owned = 0;
+    for (auto _ : perf::counted(state)) {
+        for (std::size_t i = 0; i < pointers.size(); ++i) {
+            owned += mr.owns(pointers[i]);
+            owned += mr.owns(foreign[i].get());
+        }
+    }
+    benchmark::DoNotOptimize(owned);
+
+    for (int i = 0; i < 1024; ++i) {
+        mr.deallocate(pointers[i], 8 + i % 128, 8);
+    }
+    state.SetItemsProcessed(state.iterations() * pointers.size() * 2);
+}
+BENCHMARK(BM_SpanOwnsLookup);
+
+namespace {
+
+// 当前进程的常驻内存（RSS），单位 MB；无法读取时返回 0
+double resident_mb() {
+    std::ifstream statm("/proc/self/statm");
+    std::size_t total = 0;
+    std::size_t resident = 0;
+    if (!(statm >> total >> resident)) return 0;
+    return static_cast<double>(resident * sysconf(_SC_PAGESIZE)) / (1 << 20);
+}
+
+} // namespace
+
+// 流量高峰后的 RSS 基准测试：分配 state.range(0) 个 8~128 字节对象后全部释放，再调用 release()。
+// rss_peak_mb、rss_freed_mb、rss_released_mb 分别为高峰时、释放对象后、归还内存块后的 RSS
+static void BM_SGIPoolBase_ReleaseAfterSpike(benchmark::State& state) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> size_dist(8, 128);
+    std::vector<std::pair<void*, std::size_t>> allocations(state.range(0));
+    double peak = 0;
+    double freed = 0;
+    double released = 0;
+
+    for (auto _ : perf::counted(state)) {
+        sgi_pool_resource_base pool;
+        for (auto& alloc : allocations) {
+            alloc.second = size_dist(rng);
+            alloc.first = pool.allocate_impl(alloc.second, 8);
+            std::memset(alloc.first, 1, alloc.second);
+        }
+        peak = resident_mb();
+
+        for (const auto& alloc : allocations) {
+            pool.deallocate_impl(alloc.first, alloc.second, 8);
+        }
+        freed = resident_mb();
+
+        benchmark::DoNotOptimize(pool.release());
+        released = resident_mb();
+    }
+
+    state.counters["rss_peak_mb"] = peak;
+    state.counters["rss_freed_mb"] = freed;
+    state.counters["rss_released_mb"] = released;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SGIPoolBase_ReleaseAfterSpike)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+// 批量分配与逐个分配的对比：批大小 16 到 4096，与 BM_SynchronizedPoolResource_SmallAllocations 的逐个循环相同
+static void BM_SynchronizedPoolResource_PerObjectBatch(benchmark::State& state) {
+    synchronized_pool_resource mr;
+    std::vector<void*> pointers(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        for (void*& ptr : pointers) {
+            ptr = mr.allocate(16, 8);
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        for (void* ptr : pointers) {
+            mr.deallocate(ptr, 16, 8);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SynchronizedPoolResource_PerObjectBatch)->RangeMultiplier(4)->Range(16, 4096);
+
+// 批量接口的基准测试：整批只加一次锁
+static void BM_SynchronizedPoolResource_BulkBatch(benchmark::State& state) {
+    synchronized_pool_resource mr;
+    std::vector<void*> pointers(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        mr.allocate_bulk(16, 8, pointers.size(), pointers.data());
+        benchmark::DoNotOptimize(pointers.data());
+        mr.deallocate_bulk(pointers.data(), pointers.size(), 16, 8);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SynchronizedPoolResource_BulkBatch)->RangeMultiplier(4)->Range(16, 4096);
+
+// object_pool 的基准测试：编译期大小类，单个对象的分配和释放内联
+static void BM_ObjectPool_AllocateFree(benchmark::State& state) {
+    object_pool<std::pair<double, double>> pool;
+    std::vector<std::pair<double, double>*> pointers(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        for (auto*& ptr : pointers) {
+            ptr = pool.allocate();
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        for (auto* ptr : pointers) {
+            pool.deallocate(ptr);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ObjectPool_AllocateFree)->Arg(1000)->Arg(10000);
+
+// 对照：同样大小的对象经过 memory_resource 虚函数和运行期查表
+static void BM_UnsynchronizedPoolResource_AllocateFree(benchmark::State& state) {
+    unsynchronized_pool_resource mr;
+    std::vector<void*> pointers(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        for (void*& ptr : pointers) {
+            ptr = mr.allocate(sizeof(std::pair<double, double>), alignof(std::pair<double, double>));
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        for (void* ptr : pointers) {
+            mr.deallocate(ptr, sizeof(std::pair<double, double>), alignof(std::pair<double, double>));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UnsynchronizedPoolResource_AllocateFree)->Arg(1000)->Arg(10000);
+
+// static_pool_allocator 作为 std::map 分配器的基准测试
+static void BM_StaticPoolAllocatorMap(benchmark::State& state) {
+    object_pool<int> pool;
+    using allocator = static_pool_allocator<std::pair<const int, int>>;
+
+    for (auto _ : perf::counted(state)) {
+        std::map<int, int, std::less<int>, allocator> m(allocator(&pool.pool()));
+        for (int i = 0; i < state.range(0); ++i) {
+            m.emplace(i, i);
+        }
+        benchmark::DoNotOptimize(m.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StaticPoolAllocatorMap)->Arg(1000)->Arg(10000);
+
+// 对照：std::pmr::map 使用 unsynchronized_pool_resource
+static void BM_PolymorphicAllocatorMap(benchmark::State& state) {
+    unsynchronized_pool_resource mr;
+
+    for (auto _ : perf::counted(state)) {
+        std::pmr::map<int, int> m(&mr);
+        for (int i = 0; i < state.range(0); ++i) {
+            m.emplace(i, i);
+        }
+        benchmark::DoNotOptimize(m.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PolymorphicAllocatorMap)->Arg(1000)->Arg(10000);
+
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+#include "../include/sgi_pmr_allocator.hpp"
+#include "../include/sgi_pmr_arena.hpp"
+#include "perf_counters.hpp"
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace sgi_pmr;
+
+namespace {
+
+using header_map = std::pmr::map<int, std::pmr::string>;
+
+// 请求中的字符串内容预先生成，计时部分只包含分配和拷贝；长度超过短字符串优化的上限
+const std::vector<std::string>& header_values() {
+    static const std::vector<std::string> values = [] {
+        std::vector<std::string> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back("request header value number " + std::to_string(i));
+        }
+        return v;
+    }();
+    return values;
+}
+
+// 模拟一次请求：构建 entries 个键值对的 map
+void build_request(header_map& headers, int entries) {
+    const std::vector<std::string>& values = header_values();
+    for (int i = 0; i < entries; ++i) {
+        headers.emplace(i, values[i % values.size()]);
+    }
+    benchmark::DoNotOptimize(headers.size());
+}
+
+} // namespace
+
+// 请求循环的基准测试：对象逐个释放回池
+template <typename Resource>
+static void BM_RequestLoop_PoolFree(benchmark::State& state) {
+    Resource pool;
+    const int entries = static_cast<int>(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        header_map headers(&pool);
+        build_request(headers, entries);
+    }
+
+    state.SetItemsProcessed(state.iterations() * entries);
+}
+BENCHMARK_TEMPLATE(BM_RequestLoop_PoolFree, unsynchronized_pool_resource)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_RequestLoop_PoolFree, synchronized_pool_resource)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_RequestLoop_PoolFree, std::pmr::unsynchronized_pool_resource)->Arg(100)->Arg(1000);
+
+// 请求循环的基准测试：容器正常析构（释放为空操作），请求结束时整体 reset
+template <typename Upstream>
+static void BM_RequestLoop_ArenaReset(benchmark::State& state) {
+    Upstream pool;
+    arena_resource arena(&pool);
+    const int entries = static_cast<int>(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        {
+            header_map headers(&arena);
+            build_request(headers, entries);
+        }
+        arena.reset();
+    }
+
+    state.SetItemsProcessed(state.iterations() * entries);
+}
+BENCHMARK_TEMPLATE(BM_RequestLoop_ArenaReset, unsynchronized_pool_resource)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_RequestLoop_ArenaReset, synchronized_pool_resource)->Arg(100)->Arg(1000);
+
+// 请求循环的基准测试：容器本身也在 arena 中分配且不析构，reset 一次回收全部内存
+static void BM_RequestLoop_ArenaWinkOut(benchmark::State& state) {
+    unsynchronized_pool_resource pool;
+    arena_resource arena(&pool);
+    const int entries = static_cast<int>(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        std::pmr::polymorphic_allocator<> alloc(&arena);
+        header_map* headers = alloc.new_object<header_map>();
+        build_request(*headers, entries);
+        arena.reset();
+    }
+
+    state.SetItemsProcessed(state.iterations() * entries);
+}
+BENCHMARK(BM_RequestLoop_ArenaWinkOut)->Arg(100)->Arg(1000);
+
+// 对照：标准库的单调资源，每次请求重新构造
+static void BM_RequestLoop_StdMonotonic(benchmark::State& state) {
+    unsynchronized_pool_resource pool;
+    const int entries = static_cast<int>(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        std::pmr::monotonic_buffer_resource arena(arena_resource::DEFAULT_BLOCK_BYTES, &pool);
+        header_map headers(&arena);
+        build_request(headers, entries);
+    }
+
+    state.SetItemsProcessed(state.iterations() * entries);
+}
+BENCHMARK(BM_RequestLoop_StdMonotonic)->Arg(100)->Arg(1000);
@@ -0,0 +1,277 @@
+#include <benchmark/benchmark.h>
+#include "../include/sgi_pmr_allocator.hpp"
+#include "../include/sgi_pmr_thread_cache.hpp"
+#include "../include/sgi_pmr_lockfree.hpp"
+#include "../include/sgi_pmr_sharded.hpp"
+#include "../include/sgi_pmr_thread_heap.hpp"
+#include "../include/sgi_pmr_slab.hpp"
+#include "perf_counters.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 节点容器基准测试：pmr::map、pmr::unordered_map、pmr::list 和 pmr::string 的插入、删除、查找和遍历，
+// 覆盖各个通用内存资源和不同的元素大小。元素以 0 到 n-1 的键标识，键按随机顺序插入和删除；
+// 查找和遍历之前先随机删除一半再补回，模拟长时间运行后节点在内存中的分布。
+// arena_resource 和 monotonic_buffer_resource 不回收单个对象，反复增删会无限增长，不在此列。
+
+using namespace sgi_pmr;
+
+namespace {
+
+// 资源的持有者，默认资源不需要创建
+template <typename Resource>
+struct resource_holder {
+    Resource resource;
+    std::pmr::memory_resource* get() { return &resource; }
+};
+
+template <>
+struct resource_holder<std::pmr::memory_resource> {
+    std::pmr::memory_resource* get() { return std::pmr::get_default_resource(); }
+};
+
+// Bytes 字节的元素
+template <std::size_t Bytes>
+struct payload {
+    static_assert(Bytes >= sizeof(std::uint64_t));
+
+    std::uint64_t value = 0;
+    std::array<char, Bytes - sizeof(std::uint64_t)> padding{};
+
+    payload() = default;
+    explicit payload(std::uint64_t v) : value(v) {}
+};
+
+// 以下包装把各容器统一成按键插入、查找、删除和遍历的接口
+
+template <std::size_t Bytes>
+class pmr_map {
+    std::pmr::map<std::uint64_t, payload<Bytes>> map_;
+
+public:
+    pmr_map(std::pmr::memory_resource* mr, std::size_t) : map_(mr) {}
+
+    void insert(std::uint64_t key) { map_.emplace(key, payload<Bytes>(key)); }
+    std::uint64_t lookup(std::uint64_t key) const { return map_.find(key)->second.value; }
+    void erase(std::uint64_t key) { map_.erase(key); }
+
+    std::uint64_t iterate() const {
+        std::uint64_t sum = 0;
+        for (const auto& entry : map_) sum += entry.second.value;
+        return sum;
+    }
+};
+
+template <std::size_t Bytes>
+class pmr_unordered_map {
+    std::pmr::unordered_map<std::uint64_t, payload<Bytes>> map_;
+
+public:
+    // 预留桶数组，插入时只分配节点
+    pmr_unordered_map(std::pmr::memory_resource* mr, std::size_t n) : map_(n, mr) {}
+
+    void insert(std::uint64_t key) { map_.emplace(key, payload<Bytes>(key)); }
+    std::uint64_t lookup(std::uint64_t key) const { return map_.find(key)->second.value; }
+    void erase(std::uint64_t key) { map_.erase(key); }
+
+    std::uint64_t iterate() const {
+        std::uint64_t sum = 0;
+        for (const auto& entry : map_) sum += entry.second.value;
+        return sum;
+    }
+};
+
+// 链表按插入顺序连接节点；按键访问通过不经过被测资源的迭代器索引
+template <std::size_t Bytes>
+class pmr_list {
+    std::pmr::list<payload<Bytes>> list_;
+    std::vector<typename std::pmr::list<payload<Bytes>>::iterator> index_;
+
+public:
+    pmr_list(std::pmr::memory_resource* mr, std::size_t n) : list_(mr), index_(n) {}
+
+    void insert(std::uint64_t key) { index_[key] = list_.emplace(list_.end(), key); }
+    std::uint64_t lookup(std::uint64_t key) const { return index_[key]->value; }
+    void erase(std::uint64_t key) { list_.erase(index_[key]); }
+
+    std::uint64_t iterate() const {
+        std::uint64_t sum = 0;
+        for (const auto& element : list_) sum += element.value;
+        return sum;
+    }
+};
+
+// 每个键对应一个长度为 Bytes 的字符串，超过短字符串优化的长度，内容存放在资源分配的缓冲区中
+template <std::size_t Bytes>
+class pmr_string {
+    std::pmr::vector<std::pmr::string> strings_;
+
+public:
+    pmr_string(std::pmr::memory_resource* mr, std::size_t n) : strings_(n, mr) {}
+
+    void insert(std::uint64_t key) { strings_[key].assign(Bytes, static_cast<char>('a' + key % 26)); }
+    std::uint64_t lookup(std::uint64_t key) const { return static_cast<unsigned char>(strings_[key].back()); }
+
+    void erase(std::uint64_t key) {
+        // clear 不归还缓冲区，与空字符串交换才会释放
+        std::pmr::string empty(strings_.get_allocator());
+        strings_[key].swap(empty);
+    }
+
+    std::uint64_t iterate() const {
+        std::uint64_t sum = 0;
+        for (const std::pmr::string& s : strings_) {
+            if (!s.empty()) sum += static_cast<unsigned char>(s.back());
+        }
+        return sum;
+    }
+};
+
+std::vector<std::uint64_t> shuffled_keys(std::size_t n, std::uint64_t seed) {
+    std::vector<std::uint64_t> keys(n);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::mt19937_64 rng(seed);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    return keys;
+}
+
+// 按随机顺序插入全部键，再随机删除一半并补回
+template <typename Container>
+void fill_after_churn(Container& c, const std::vector<std::uint64_t>& keys) {
+    for (std::uint64_t key : keys) c.insert(key);
+
+    std::mt19937_64 rng(11);
+    std::vector<std::uint64_t> removed;
+    for (std::uint64_t key : keys) {
+        if (rng() % 2) {
+            c.erase(key);
+            removed.push_back(key);
+        }
+    }
+    std::shuffle(removed.begin(), removed.end(), rng);
+    for (std::uint64_t key : removed) c.insert(key);
+}
+
+} // namespace
+
+// 插入：在空容器中按随机顺序插入 n 个键，容器的创建和销毁不计时
+template <typename Resource, typename Container>
+static void BM_ContainerInsert(benchmark::State& state) {
+    resource_holder<Resource> holder;
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<std::uint64_t> keys = shuffled_keys(n, 1);
+
+    for (auto _ : perf::counted(state)) {
+        perf::pause(state);
+        auto* c = new Container(holder.get(), n);
+        perf::resume(state);
+
+        for (std::uint64_t key : keys) c->insert(key);
+        benchmark::ClobberMemory();
+
+        perf::pause(state);
+        delete c;
+        perf::resume(state);
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// 删除：按另一个随机顺序删除全部 n 个键，容器的填充不计时
+template <typename Resource, typename Container>
+static void BM_ContainerErase(benchmark::State& state) {
+    resource_holder<Resource> holder;
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<std::uint64_t> insert_order = shuffled_keys(n, 1);
+    std::vector<std::uint64_t> erase_order = shuffled_keys(n, 2);
+
+    for (auto _ : perf::counted(state)) {
+        perf::pause(state);
+        auto* c = new Container(holder.get(), n);
+        for (std::uint64_t key : insert_order) c->insert(key);
+        perf::resume(state);
+
+        for (std::uint64_t key : erase_order) c->erase(key);
+        benchmark::ClobberMemory();
+
+        perf::pause(state);
+        delete c;
+        perf::resume(state);
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// 查找：按随机顺序访问全部 n 个键对应的元素
+template <typename Resource, typename Container>
+static void BM_ContainerLookup(benchmark::State& state) {
+    resource_holder<Resource> holder;
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    Container c(holder.get(), n);
+    fill_after_churn(c, shuffled_keys(n, 1));
+    std::vector<std::uint64_t> probes = shuffled_keys(n, 3);
+
+    for (auto _ : perf::counted(state)) {
+        std::uint64_t sum = 0;
+        for (std::uint64_t key : probes) sum += c.lookup(key);
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// 遍历：按容器自身的顺序访问全部元素，节点在内存中越紧凑越快
+template <typename Resource, typename Container>
+static void BM_ContainerIterate(benchmark::State& state) {
+    resource_holder<Resource> holder;
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    Container c(holder.get(), n);
+    fill_after_churn(c, shuffled_keys(n, 1));
+
+    for (auto _ : perf::counted(state)) {
+        benchmark::DoNotOptimize(c.iterate());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+#define SGI_CONTAINER_BENCHMARK(func, Container)                                                         \
+    BENCHMARK_TEMPLATE(func, unsynchronized_pool_resource, Container)->Arg(1 << 14);                     \
+    BENCHMARK_TEMPLATE(func, synchronized_pool_resource, Container)->Arg(1 << 14);                       \
+    BENCHMARK_TEMPLATE(func, thread_cached_pool_resource, Container)->Arg(1 << 14);                      \
+    BENCHMARK_TEMPLATE(func, lockfree_pool_resource, Container)->Arg(1 << 14);                           \
+    BENCHMARK_TEMPLATE(func, sharded_pool_resource, Container)->Arg(1 << 14);                            \
+    BENCHMARK_TEMPLATE(func, thread_heap_pool_resource, Container)->Arg(1 << 14);                        \
+    BENCHMARK_TEMPLATE(func, unsynchronized_slab_pool_resource, Container)->Arg(1 << 14);                \
+    BENCHMARK_TEMPLATE(func, std::pmr::unsynchronized_pool_resource, Container)->Arg(1 << 14);           \
+    BENCHMARK_TEMPLATE(func, std::pmr::synchronized_pool_resource, Container)->Arg(1 << 14);             \
+    BENCHMARK_TEMPLATE(func, std::pmr::memory_resource, Container)->Arg(1 << 14)
+
+#define SGI_CONTAINER_OPERATIONS(Container)                \
+    SGI_CONTAINER_BENCHMARK(BM_ContainerInsert, Container); \
+    SGI_CONTAINER_BENCHMARK(BM_ContainerErase, Container);  \
+    SGI_CONTAINER_BENCHMARK(BM_ContainerLookup, Container); \
+    SGI_CONTAINER_BENCHMARK(BM_ContainerIterate, Container)
+
+// 元素大小：8 字节的节点落在默认池的小大小类，64 字节接近上限，256 字节超过默认 max_bytes 交给上游
+SGI_CONTAINER_OPERATIONS(pmr_map<8>);
+SGI_CONTAINER_OPERATIONS(pmr_map<64>);
+SGI_CONTAINER_OPERATIONS(pmr_map<256>);
+SGI_CONTAINER_OPERATIONS(pmr_unordered_map<8>);
+SGI_CONTAINER_OPERATIONS(pmr_unordered_map<64>);
+SGI_CONTAINER_OPERATIONS(pmr_unordered_map<256>);
+SGI_CONTAINER_OPERATIONS(pmr_list<8>);
+SGI_CONTAINER_OPERATIONS(pmr_list<64>);
+SGI_CONTAINER_OPERATIONS(pmr_list<256>);
+SGI_CONTAINER_OPERATIONS(pmr_string<32>);
+SGI_CONTAINER_OPERATIONS(pmr_string<100>);
+SGI_CONTAINER_OPERATIONS(pmr_string<400>);
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include "../include/sgi_pmr_allocator.hpp"
+#include "../include/sgi_pmr_huge_page.hpp"
+#include "perf_counters.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace sgi_pmr;
+
+namespace {
+
+struct list_node {
+    list_node* next;
+    std::uint64_t payload[3];
+};
+
+// 在 pool 中分配 count 个节点，再按随机排列串成环，遍历时每一步都跳到不相邻的位置
+list_node* build_random_ring(std::pmr::memory_resource& pool, std::size_t count,
+                             std::vector<list_node*>& nodes) {
+    nodes.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        nodes[i] = static_cast<list_node*>(pool.allocate(sizeof(list_node), alignof(list_node)));
+        nodes[i]->payload[0] = i;
+    }
+
+    std::vector<std::size_t> order(count);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(42));
+    for (std::size_t i = 0; i < count; ++i) {
+        nodes[order[i]]->next = nodes[order[(i + 1) % count]];
+    }
+    return nodes[order[0]];
+}
+
+} // namespace
+
+// 随机访问遍历池分配链表的基准测试：UseHugePages 为 true 时内存块来自
+// huge_page_resource，否则来自默认的 malloc 上游；节点总量超过 TLB 覆盖范围后，
+// 大页映射可以明显减少 TLB 缺失
+template <bool UseHugePages>
+static void BM_RandomListTraversal(benchmark::State& state) {
+    const std::size_t count = static_cast<std::size_t>(state.range(0));
+
+    std::unique_ptr<huge_page_resource> pages;
+    std::pmr::memory_resource* upstream = std::pmr::get_default_resource();
+    if (UseHugePages) {
+        pages = std::make_unique<huge_page_resource>();
+        upstream = pages.get();
+    }
+
+    std::vector<list_node*> nodes;
+    list_node* head;
+    {
+        unsynchronized_pool_resource pool(upstream);
+        head = build_random_ring(pool, count, nodes);
+
+        for (auto _ : perf::counted(state)) {
+            std::uint64_t sum = 0;
+            list_node* n = head;
+            for (std::size_t i = 0; i < count; ++i) {
+                sum += n->payload[0];
+                n = n->next;
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * count * sizeof(list_node));
+}
+BENCHMARK_TEMPLATE(BM_RandomListTraversal, false)->Arg(1 << 14)->Arg(1 << 18)->Arg(1 << 21)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_RandomListTraversal, true)->Arg(1 << 14)->Arg(1 << 18)->Arg(1 << 21)->Unit(benchmark::kMicrosecond);
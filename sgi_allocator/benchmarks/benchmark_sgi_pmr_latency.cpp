@@ -0,0 +1,179 @@
+#include <benchmark/benchmark.h>
+#include "../include/sgi_pmr_allocator.hpp"
+#include "../include/sgi_pmr_thread_cache.hpp"
+#include "../include/sgi_pmr_lockfree.hpp"
+#include "../include/sgi_pmr_sharded.hpp"
+#include "../include/sgi_pmr_thread_heap.hpp"
+#include "../include/sgi_pmr_slab.hpp"
+#include "perf_counters.hpp"
+#include "latency_histogram.hpp"
+#include "size_distribution.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// 单次分配延迟基准测试：逐个记录 allocate 和 deallocate 的耗时，输出 p50、p99、p99.9 和最大值（纳秒）。
+// 吞吐量基准把 refill 和 chunk_alloc 的周期性停顿平均掉了，这里按分位数观察尾部延迟。
+// 每次运行使用新建的资源，冷启动阶段的补充和向上游申请内存块都计入统计。
+
+using namespace sgi_pmr;
+using perf::latency_clock;
+using perf::latency_histogram;
+using perf::random_size;
+
+namespace {
+
+// 一次运行共享的资源和合并后的直方图，在 Setup 中创建、Teardown 中销毁
+template <typename Resource>
+struct latency_run {
+    static inline Resource* instance = nullptr;
+    static inline latency_histogram allocate;
+    static inline latency_histogram deallocate;
+    static inline std::mutex mutex;
+    static inline std::atomic<int> merged{0};
+
+    static std::pmr::memory_resource* resource() {
+        if constexpr (std::is_same_v<Resource, std::pmr::memory_resource>) {
+            return std::pmr::get_default_resource();
+        } else {
+            return instance;
+        }
+    }
+
+    static void setup(const benchmark::State&) {
+        if constexpr (!std::is_same_v<Resource, std::pmr::memory_resource>) {
+            instance = new Resource;
+        }
+        allocate.clear();
+        deallocate.clear();
+        merged.store(0);
+    }
+
+    static void teardown(const benchmark::State&) {
+        if constexpr (!std::is_same_v<Resource, std::pmr::memory_resource>) {
+            delete instance;
+            instance = nullptr;
+        }
+    }
+
+    // 各线程合并自己的直方图；0 号线程等全部线程合并后输出，其他线程不设置计数器，框架累加后即为结果
+    static void report(benchmark::State& state, const latency_histogram& a, const latency_histogram& d) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            allocate.merge(a);
+            deallocate.merge(d);
+        }
+        merged.fetch_add(1, std::memory_order_release);
+        if (state.thread_index() != 0) return;
+
+        while (merged.load(std::memory_order_acquire) < state.threads()) {
+            std::this_thread::yield();
+        }
+        set_counters(state, "alloc", allocate);
+        set_counters(state, "free", deallocate);
+    }
+
+    static void set_counters(benchmark::State& state, const char* prefix, const latency_histogram& h) {
+        const double ns = latency_clock::ns_per_tick();
+        const std::string p = prefix;
+        state.counters[p + "_p50"] = static_cast<double>(h.percentile(0.50)) * ns;
+        state.counters[p + "_p99"] = static_cast<double>(h.percentile(0.99)) * ns;
+        state.counters[p + "_p99.9"] = static_cast<double>(h.percentile(0.999)) * ns;
+        state.counters[p + "_max"] = static_cast<double>(h.max()) * ns;
+    }
+};
+
+struct sized_ptr {
+    void* p = nullptr;
+    std::size_t bytes = 0;
+};
+
+// 扣除读取时钟本身的开销
+std::uint64_t measured(std::uint64_t begin, std::uint64_t end) {
+    std::uint64_t ticks = end - begin;
+    std::uint64_t overhead = latency_clock::overhead();
+    return ticks > overhead ? ticks - overhead : 0;
+}
+
+int contended_threads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return std::max(4, static_cast<int>(n));
+}
+
+} // namespace
+
+// 每个线程维护 range(0) 个存活对象组成的环，每次迭代释放环中最早的对象并分配一个新的（8 到 256 字节），
+// 超过默认 max_bytes 的部分交给上游。只有 allocate 和 deallocate 调用本身计入直方图
+template <typename Resource>
+static void BM_AllocationLatency(benchmark::State& state) {
+    using run = latency_run<Resource>;
+    std::pmr::memory_resource* mr = run::resource();
+    const std::size_t live = static_cast<std::size_t>(state.range(0));
+    std::vector<sized_ptr> ring(live);
+    std::size_t next = 0;
+    std::mt19937 rng(static_cast<unsigned>(state.thread_index()) + 1);
+    latency_histogram allocate_hist;
+    latency_histogram deallocate_hist;
+    latency_clock::overhead();
+
+    for (auto _ : perf::counted(state)) {
+        sized_ptr& slot = ring[next];
+        if (slot.p) {
+            std::uint64_t begin = latency_clock::now();
+            mr->deallocate(slot.p, slot.bytes, 8);
+            std::uint64_t end = latency_clock::now();
+            deallocate_hist.record(measured(begin, end));
+        }
+
+        slot.bytes = random_size(rng, 256);
+        std::uint64_t begin = latency_clock::now();
+        slot.p = mr->allocate(slot.bytes, 8);
+        std::uint64_t end = latency_clock::now();
+        benchmark::DoNotOptimize(slot.p);
+        allocate_hist.record(measured(begin, end));
+
+        next = next + 1 == live ? 0 : next + 1;
+    }
+
+    for (const sized_ptr& o : ring) {
+        if (o.p) mr->deallocate(o.p, o.bytes, 8);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    run::report(state, allocate_hist, deallocate_hist);
+}
+
+// 单线程和多线程竞争（至少 4 个线程，单核机器上体现持锁线程被抢占的停顿）
+#define SGI_LATENCY_BENCHMARK(Resource)                       \
+    BENCHMARK_TEMPLATE(BM_AllocationLatency, Resource)        \
+        ->Setup(latency_run<Resource>::setup)                 \
+        ->Teardown(latency_run<Resource>::teardown)           \
+        ->ArgName("live")                                     \
+        ->Arg(1024)                                           \
+        ->Arg(65536)                                          \
+        ->Threads(1)                                          \
+        ->Threads(contended_threads())
+
+// 非线程安全的资源只测单线程
+#define SGI_LATENCY_BENCHMARK_SINGLE(Resource)                \
+    BENCHMARK_TEMPLATE(BM_AllocationLatency, Resource)        \
+        ->Setup(latency_run<Resource>::setup)                 \
+        ->Teardown(latency_run<Resource>::teardown)           \
+        ->ArgName("live")                                     \
+        ->Arg(1024)                                           \
+        ->Arg(65536)
+
+SGI_LATENCY_BENCHMARK_SINGLE(unsynchronized_pool_resource);
+SGI_LATENCY_BENCHMARK_SINGLE(unsynchronized_slab_pool_resource);
+SGI_LATENCY_BENCHMARK_SINGLE(std::pmr::unsynchronized_pool_resource);
+SGI_LATENCY_BENCHMARK(synchronized_pool_resource);
+SGI_LATENCY_BENCHMARK(thread_cached_pool_resource);
+SGI_LATENCY_BENCHMARK(lockfree_pool_resource);
+SGI_LATENCY_BENCHMARK(sharded_pool_resource);
+SGI_LATENCY_BENCHMARK(thread_heap_pool_resource);
+SGI_LATENCY_BENCHMARK(std::pmr::synchronized_pool_resource);
+SGI_LATENCY_BENCHMARK(std::pmr::memory_resource);
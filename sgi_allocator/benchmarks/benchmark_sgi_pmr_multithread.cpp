@@ -0,0 +1,495 @@
+#include <benchmark/benchmark.h>
+#include "../include/sgi_pmr_allocator.hpp"
+#include "../include/sgi_pmr_thread_cache.hpp"
+#include "../include/sgi_pmr_lockfree.hpp"
+#include "../include/sgi_pmr_sharded.hpp"
+#include "../include/sgi_pmr_thread_heap.hpp"
+#include "perf_counters.hpp"
+#include "size_distribution.hpp"
+#include <memory_resource>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+
+using namespace sgi_pmr;
+using perf::random_size;
+
+namespace {
+
+// 所有线程共享同一个资源实例，在 Setup 中创建、Teardown 中销毁
+template <typename Resource>
+struct shared_resource {
+    static inline Resource* instance = nullptr;
+
+    static void setup(const benchmark::State&) { instance = new Resource; }
+    static void teardown(const benchmark::State&) {
+        delete instance;
+        instance = nullptr;
+    }
+};
+
+// 默认资源无需创建
+template <>
+struct shared_resource<std::pmr::memory_resource> {
+    static inline std::pmr::memory_resource* instance = nullptr;
+
+    static void setup(const benchmark::State&) { instance = std::pmr::get_default_resource(); }
+    static void teardown(const benchmark::State&) { instance = nullptr; }
+};
+
+int max_threads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 4 : static_cast<int>(n);
+}
+
+// 高线程数：至少 16 个线程，用于观察超额订阅下的锁竞争
+int high_threads() {
+    return std::max(16, max_threads() * 2);
+}
+
+} // namespace
+
+// 多线程小对象分配基准测试：每个线程分配一批 16 字节对象后全部释放
+template <typename Resource>
+static void BM_MT_SmallAllocations(benchmark::State& state) {
+    std::pmr::memory_resource* mr = shared_resource<Resource>::instance;
+    const int batch = static_cast<int>(state.range(0));
+    std::vector<void*> pointers(batch);
+
+    for (auto _ : perf::counted(state)) {
+        for (int i = 0; i < batch; ++i) {
+            pointers[i] = mr->allocate(16, 8);
+            benchmark::DoNotOptimize(pointers[i]);
+        }
+
+        for (int i = 0; i < batch; ++i) {
+            mr->deallocate(pointers[i], 16, 8);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+// 多线程按大小类分布的基准测试：每个线程使用不同的大小类，
+// 用于观察不同大小类之间是否相互竞争
+template <typename Resource>
+static void BM_MT_PerThreadSizeClass(benchmark::State& state) {
+    std::pmr::memory_resource* mr = shared_resource<Resource>::instance;
+    const int batch = static_cast<int>(state.range(0));
+    const std::size_t size = 8 + (state.thread_index() % 16) * 8;
+    std::vector<void*> pointers(batch);
+
+    for (auto _ : perf::counted(state)) {
+        for (int i = 0; i < batch; ++i) {
+            pointers[i] = mr->allocate(size, 8);
+            benchmark::DoNotOptimize(pointers[i]);
+        }
+
+        for (int i = 0; i < batch; ++i) {
+            mr->deallocate(pointers[i], size, 8);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+#define SGI_MT_BENCHMARK(func, Resource)                          \
+    BENCHMARK_TEMPLATE(func, Resource)                            \
+        ->Setup(shared_resource<Resource>::setup)                 \
+        ->Teardown(shared_resource<Resource>::teardown)           \
+        ->Arg(1000)                                               \
+        ->ThreadRange(1, max_threads())                           \
+        ->Threads(high_threads())                                 \
+        ->UseRealTime()
+
+SGI_MT_BENCHMARK(BM_MT_SmallAllocations, synchronized_pool_resource);
+SGI_MT_BENCHMARK(BM_MT_SmallAllocations, thread_cached_pool_resource);
+SGI_MT_BENCHMARK(BM_MT_SmallAllocations, lockfree_pool_resource);
+SGI_MT_BENCHMARK(BM_MT_SmallAllocations, sharded_pool_resource);
+SGI_MT_BENCHMARK(BM_MT_SmallAllocations, thread_heap_pool_resource);
+SGI_MT_BENCHMARK(BM_MT_SmallAllocations, std::pmr::synchronized_pool_resource);
+SGI_MT_BENCHMARK(BM_MT_SmallAllocations, std::pmr::memory_resource);
+
+SGI_MT_BENCHMARK(BM_MT_PerThreadSizeClass, synchronized_pool_resource);
+SGI_MT_BENCHMARK(BM_MT_PerThreadSizeClass, lockfree_pool_resource);
+SGI_MT_BENCHMARK(BM_MT_PerThreadSizeClass, sharded_pool_resource);
+SGI_MT_BENCHMARK(BM_MT_PerThreadSizeClass, std::pmr::synchronized_pool_resource);
+
+namespace {
+
+// 单生产者单消费者的环形队列，生产者和消费者的下标各占一个缓存行
+struct spsc_ring {
+    static constexpr std::size_t CAPACITY = 1024;
+
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+    void* slots[CAPACITY];
+
+    bool push(void* p) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == CAPACITY) return false;
+        slots[t % CAPACITY] = p;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    void* pop() {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return nullptr;
+        void* p = slots[h % CAPACITY];
+        head.store(h + 1, std::memory_order_release);
+        return p;
+    }
+};
+
+} // namespace
+
+// 生产者/消费者基准测试：range(0) 个生产者分配 64 字节消息，经队列交给 range(1) 个消费者释放。
+// 生产者 p 发给消费者 c 的消息走独立的队列 (p, c)，每次迭代传递 MESSAGES 条消息
+template <typename Resource>
+static void BM_ProducerConsumer(benchmark::State& state) {
+    constexpr std::size_t MESSAGE_BYTES = 64;
+    constexpr int MESSAGES = 1 << 16;
+    const int producers = static_cast<int>(state.range(0));
+    const int consumers = static_cast<int>(state.range(1));
+
+    shared_resource<Resource>::setup(state);
+    std::pmr::memory_resource* mr = shared_resource<Resource>::instance;
+
+    // 生产者和消费者是本函数创建的线程，计数器同时统计子线程
+    for (auto _ : perf::counted(state, perf::counter_set::scope::with_child_threads)) {
+        std::vector<spsc_ring> rings(producers * consumers);
+        std::atomic<int> remaining{MESSAGES};
+        std::vector<std::thread> threads;
+
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p]() {
+                int count = MESSAGES / producers + (p < MESSAGES % producers ? 1 : 0);
+                for (int i = 0; i < count; ++i) {
+                    void* message = mr->allocate(MESSAGE_BYTES, 8);
+                    std::memset(message, i, MESSAGE_BYTES);
+                    spsc_ring& ring = rings[p * consumers + i % consumers];
+                    while (!ring.push(message)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for (int c = 0; c < consumers; ++c) {
+            threads.emplace_back([&, c]() {
+                while (remaining.load(std::memory_order_relaxed) > 0) {
+                    bool idle = true;
+                    for (int p = 0; p < producers; ++p) {
+                        while (void* message = rings[p * consumers + c].pop()) {
+                            benchmark::DoNotOptimize(*static_cast<char*>(message));
+                            mr->deallocate(message, MESSAGE_BYTES, 8);
+                            remaining.fetch_sub(1, std::memory_order_relaxed);
+                            idle = false;
+                        }
+                    }
+                    if (idle) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    shared_resource<Resource>::teardown(state);
+    state.SetItemsProcessed(state.iterations() * MESSAGES);
+}
+
+#define SGI_PC_BENCHMARK(Resource)                                \
+    BENCHMARK_TEMPLATE(BM_ProducerConsumer, Resource)             \
+        ->ArgNames({"producers", "consumers"})                    \
+        ->Args({1, 1})                                            \
+        ->Args({1, 4})                                            \
+        ->Args({4, 1})                                            \
+        ->UseRealTime()                                           \
+        ->Unit(benchmark::kMillisecond)
+
+SGI_PC_BENCHMARK(synchronized_pool_resource);
+SGI_PC_BENCHMARK(thread_cached_pool_resource);
+SGI_PC_BENCHMARK(lockfree_pool_resource);
+SGI_PC_BENCHMARK(sharded_pool_resource);
+SGI_PC_BENCHMARK(thread_heap_pool_resource);
+SGI_PC_BENCHMARK(std::pmr::synchronized_pool_resource);
+SGI_PC_BENCHMARK(std::pmr::memory_resource);
+
+// 多线程分配器负载套件：Larson 服务器模拟、threadtest、xmalloc 式生产者/消费者和随机增删。
+// 每次迭代创建 range(0) 个线程同时运行负载，只计从所有线程就绪到全部结束的时间；
+// items_per_second 为所有线程合计的每秒分配次数（每次分配都有一次对应的释放），
+// efficiency 为 N 线程吞吐量相对单线程吞吐量 N 倍的比例，1 表示线性扩展。
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// 同时启动 threads 个线程运行 body(thread_index)，返回从全部线程就绪到全部结束的秒数
+template <typename Body>
+double run_threads(int threads, Body body) {
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            ready.fetch_add(1, std::memory_order_relaxed);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            body(t);
+        });
+    }
+
+    while (ready.load(std::memory_order_relaxed) < threads) {
+        std::this_thread::yield();
+    }
+    auto start = clock_type::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) {
+        w.join();
+    }
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// 运行负载并报告吞吐量和扩展效率。workload(mr, threads, param) 运行一轮并返回 {秒数, 分配次数}；
+// 单线程的吞吐量按负载和 range(1) 记录下来，作为同一资源多线程运行的基准
+template <typename Resource, typename Workload>
+void run_mt_workload(benchmark::State& state, Workload workload) {
+    static std::map<std::int64_t, double> single_thread_rate;
+
+    const int threads = static_cast<int>(state.range(0));
+    const std::int64_t param = state.range(1);
+    shared_resource<Resource>::setup(state);
+    std::pmr::memory_resource* mr = shared_resource<Resource>::instance;
+
+    double total_seconds = 0;
+    std::int64_t total_ops = 0;
+    for (auto _ : perf::counted(state, perf::counter_set::scope::with_child_threads)) {
+        auto [seconds, ops] = workload(mr, threads, param);
+        state.SetIterationTime(seconds);
+        total_seconds += seconds;
+        total_ops += ops;
+    }
+    shared_resource<Resource>::teardown(state);
+
+    state.SetItemsProcessed(total_ops);
+    double rate = total_seconds > 0 ? static_cast<double>(total_ops) / total_seconds : 0;
+    if (threads == 1) {
+        single_thread_rate[param] = rate;
+    }
+    auto it = single_thread_rate.find(param);
+    if (it != single_thread_rate.end() && it->second > 0) {
+        state.counters["efficiency"] = rate / (it->second * threads);
+    }
+}
+
+struct sized_ptr {
+    void* p = nullptr;
+    std::size_t bytes = 0;
+};
+
+} // namespace
+
+// Larson：每个线程维护 range(1) 个存活对象，反复随机释放一个并分配一个新的（8 到 256 字节）。
+// 每 ROUND 次替换后线程把自己的对象数组交给一个共享队列并取走最早放入的数组，
+// 模拟服务器把连接交给另一个工作线程，对象由分配它的线程之外的线程释放
+template <typename Resource>
+static void BM_MT_Larson(benchmark::State& state) {
+    run_mt_workload<Resource>(state, [](std::pmr::memory_resource* mr, int threads, std::int64_t live) {
+        constexpr int OPS = 1 << 16;
+        constexpr int ROUND = 1024;
+        std::mutex mutex;
+        std::deque<std::vector<sized_ptr>> handoff;
+
+        double seconds = run_threads(threads, [&](int t) {
+            std::mt19937 rng(t + 1);
+            std::vector<sized_ptr> objects(live);
+            for (sized_ptr& o : objects) {
+                o.bytes = random_size(rng, 256);
+                o.p = mr->allocate(o.bytes, 8);
+            }
+            for (int i = 0; i < OPS; ++i) {
+                sized_ptr& o = objects[rng() % objects.size()];
+                mr->deallocate(o.p, o.bytes, 8);
+                o.bytes = random_size(rng, 256);
+                o.p = mr->allocate(o.bytes, 8);
+                benchmark::DoNotOptimize(o.p);
+
+                if ((i + 1) % ROUND == 0) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    handoff.push_back(std::move(objects));
+                    objects = std::move(handoff.front());
+                    handoff.pop_front();
+                }
+            }
+            for (sized_ptr& o : objects) {
+                mr->deallocate(o.p, o.bytes, 8);
+            }
+        });
+        return std::pair{seconds, (OPS + live) * threads};
+    });
+}
+
+// threadtest：每个线程反复分配 range(1) 个 64 字节对象再全部释放，线程之间不共享对象
+template <typename Resource>
+static void BM_MT_ThreadTest(benchmark::State& state) {
+    run_mt_workload<Resource>(state, [](std::pmr::memory_resource* mr, int threads, std::int64_t batch) {
+        constexpr std::int64_t OPS = 1 << 16;
+        const std::int64_t rounds = std::max<std::int64_t>(1, OPS / batch);
+
+        double seconds = run_threads(threads, [&](int) {
+            std::vector<void*> pointers(batch);
+            for (std::int64_t r = 0; r < rounds; ++r) {
+                for (void*& p : pointers) {
+                    p = mr->allocate(64, 8);
+                    benchmark::DoNotOptimize(p);
+                }
+                for (void* p : pointers) {
+                    mr->deallocate(p, 64, 8);
+                }
+            }
+        });
+        return std::pair{seconds, rounds * batch * threads};
+    });
+}
+
+// xmalloc：每个线程分配一批 range(1) 个对象（8 到 128 字节）放入共享队列，
+// 再取出最早放入的一批（通常来自其他线程）全部释放。每个线程先多放一批，
+// 保证取出的不是刚放入的那批；剩余的批在所有线程结束后释放
+template <typename Resource>
+static void BM_MT_Xmalloc(benchmark::State& state) {
+    run_mt_workload<Resource>(state, [](std::pmr::memory_resource* mr, int threads, std::int64_t batch) {
+        constexpr std::int64_t OPS = 1 << 16;
+        const std::int64_t batches = std::max<std::int64_t>(1, OPS / batch);
+        std::mutex mutex;
+        std::deque<std::vector<sized_ptr>> queue;
+
+        auto fill = [&](std::mt19937& rng, std::vector<sized_ptr>& objects) {
+            objects.resize(batch);
+            for (sized_ptr& o : objects) {
+                o.bytes = random_size(rng, 128);
+                o.p = mr->allocate(o.bytes, 8);
+                benchmark::DoNotOptimize(o.p);
+            }
+        };
+
+        double seconds = run_threads(threads, [&](int t) {
+            std::mt19937 rng(t + 1);
+            std::vector<sized_ptr> objects;
+            fill(rng, objects);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(std::move(objects));
+            }
+            objects = {};
+            objects.reserve(batch);
+
+            for (std::int64_t b = 1; b < batches; ++b) {
+                fill(rng, objects);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    queue.push_back(std::move(objects));
+                    objects = std::move(queue.front());
+                    queue.pop_front();
+                }
+                for (sized_ptr& o : objects) {
+                    mr->deallocate(o.p, o.bytes, 8);
+                }
+                objects.clear();
+            }
+        });
+
+        for (auto& objects : queue) {
+            for (sized_ptr& o : objects) {
+                mr->deallocate(o.p, o.bytes, 8);
+            }
+        }
+        return std::pair{seconds, batches * batch * threads};
+    });
+}
+
+// 随机增删：每个线程有 range(1) 个槽位，随机选一个槽位，空则分配（8 到 1024 字节）、非空则释放，
+// 存活对象数稳定在槽位数的一半左右；range(1) 控制存活集的大小
+template <typename Resource>
+static void BM_MT_RandomChurn(benchmark::State& state) {
+    run_mt_workload<Resource>(state, [](std::pmr::memory_resource* mr, int threads, std::int64_t slots) {
+        constexpr int OPS = 1 << 17;
+        std::atomic<std::int64_t> allocations{0};
+
+        double seconds = run_threads(threads, [&](int t) {
+            std::mt19937 rng(t + 1);
+            std::vector<sized_ptr> objects(slots);
+            std::int64_t count = 0;
+            for (int i = 0; i < OPS; ++i) {
+                sized_ptr& o = objects[rng() % objects.size()];
+                if (o.p) {
+                    mr->deallocate(o.p, o.bytes, 8);
+                    o.p = nullptr;
+                } else {
+                    o.bytes = random_size(rng, 1024);
+                    o.p = mr->allocate(o.bytes, 8);
+                    benchmark::DoNotOptimize(o.p);
+                    ++count;
+                }
+            }
+            for (sized_ptr& o : objects) {
+                if (o.p) mr->deallocate(o.p, o.bytes, 8);
+            }
+            allocations.fetch_add(count, std::memory_order_relaxed);
+        });
+        return std::pair{seconds, allocations.load()};
+    });
+}
+
+namespace {
+
+// 线程数为 1 到 hardware_concurrency 之间的 2 的幂，再加上 hardware_concurrency 本身
+void suite_args(benchmark::internal::Benchmark* b, std::initializer_list<std::int64_t> params) {
+    std::vector<std::int64_t> counts;
+    for (int n = 1; n < max_threads(); n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(max_threads());
+    for (std::int64_t param : params) {
+        for (std::int64_t n : counts) {
+            b->Args({n, param});
+        }
+    }
+}
+
+} // namespace
+
+#define SGI_SUITE_BENCHMARK(func, Resource, param_name, ...)                       \
+    BENCHMARK_TEMPLATE(func, Resource)                                              \
+        ->ArgNames({"threads", param_name})                                         \
+        ->Apply([](benchmark::internal::Benchmark* b) { suite_args(b, {__VA_ARGS__}); }) \
+        ->UseManualTime()                                                           \
+        ->Unit(benchmark::kMillisecond)
+
+#define SGI_SUITE_RESOURCES(func, param_name, ...)                                                   \
+    SGI_SUITE_BENCHMARK(func, synchronized_pool_resource, param_name, __VA_ARGS__);                  \
+    SGI_SUITE_BENCHMARK(func, thread_cached_pool_resource, param_name, __VA_ARGS__);                 \
+    SGI_SUITE_BENCHMARK(func, lockfree_pool_resource, param_name, __VA_ARGS__);                      \
+    SGI_SUITE_BENCHMARK(func, sharded_pool_resource, param_name, __VA_ARGS__);                       \
+    SGI_SUITE_BENCHMARK(func, thread_heap_pool_resource, param_name, __VA_ARGS__);                   \
+    SGI_SUITE_BENCHMARK(func, std::pmr::synchronized_pool_resource, param_name, __VA_ARGS__);        \
+    SGI_SUITE_BENCHMARK(func, std::pmr::memory_resource, param_name, __VA_ARGS__)
+
+SGI_SUITE_RESOURCES(BM_MT_Larson, "live", 1000);
+SGI_SUITE_RESOURCES(BM_MT_ThreadTest, "batch", 1000);
+SGI_SUITE_RESOURCES(BM_MT_Xmalloc, "batch", 256);
+SGI_SUITE_RESOURCES(BM_MT_RandomChurn, "slots", 1024, 65536);
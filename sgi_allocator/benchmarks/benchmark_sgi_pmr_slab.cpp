@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+#include "../include/sgi_pmr_allocator.hpp"
+#include "../include/sgi_pmr_slab.hpp"
+#include "perf_counters.hpp"
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+using namespace sgi_pmr;
+
+namespace {
+
+// 模拟长时间运行后的容器：先插入 n 个元素，再反复随机删除一半并补回，
+// 空闲链表会把新节点散布到最近释放的位置，位图 slab 则总是填补最低的空位
+void churn(std::pmr::list<std::uint64_t>& lst, std::size_t n, std::mt19937_64& rng) {
+    for (std::size_t i = 0; i < n; ++i) {
+        lst.push_back(i);
+    }
+    for (int round = 0; round < 4; ++round) {
+        for (auto it = lst.begin(); it != lst.end();) {
+            it = rng() % 2 ? lst.erase(it) : std::next(it);
+        }
+        while (lst.size() < n) {
+            lst.push_back(rng());
+        }
+    }
+}
+
+} // namespace
+
+// 节点容器遍历的基准测试：经过删除和插入后按链表顺序遍历
+template <typename Resource>
+static void BM_ListTraversalAfterChurn(benchmark::State& state) {
+    Resource mr;
+    std::mt19937_64 rng(42);
+    std::pmr::list<std::uint64_t> lst(&mr);
+    churn(lst, static_cast<std::size_t>(state.range(0)), rng);
+
+    for (auto _ : perf::counted(state)) {
+        std::uint64_t sum = 0;
+        for (std::uint64_t value : lst) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ListTraversalAfterChurn, unsynchronized_pool_resource)->Arg(10000)->Arg(1 << 18);
+BENCHMARK_TEMPLATE(BM_ListTraversalAfterChurn, unsynchronized_slab_pool_resource)->Arg(10000)->Arg(1 << 18);
+BENCHMARK_TEMPLATE(BM_ListTraversalAfterChurn, std::pmr::unsynchronized_pool_resource)->Arg(10000)->Arg(1 << 18);
+
+// 有序容器遍历的基准测试：随机插入和删除后中序遍历
+template <typename Resource>
+static void BM_MapTraversalAfterChurn(benchmark::State& state) {
+    Resource mr;
+    std::mt19937_64 rng(7);
+    std::pmr::map<std::uint64_t, std::uint64_t> m(&mr);
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    while (m.size() < n) {
+        m.emplace(rng() % (n * 4), 1);
+    }
+    for (std::size_t i = 0; i < n * 2; ++i) {
+        m.erase(rng() % (n * 4));
+        m.emplace(rng() % (n * 4), 1);
+    }
+
+    for (auto _ : perf::counted(state)) {
+        std::uint64_t sum = 0;
+        for (const auto& entry : m) {
+            sum += entry.second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * m.size());
+}
+BENCHMARK_TEMPLATE(BM_MapTraversalAfterChurn, unsynchronized_pool_resource)->Arg(10000)->Arg(1 << 18);
+BENCHMARK_TEMPLATE(BM_MapTraversalAfterChurn, unsynchronized_slab_pool_resource)->Arg(10000)->Arg(1 << 18);
+
+// 分配与释放本身的开销
+template <typename Resource>
+static void BM_SlabAllocateFree(benchmark::State& state) {
+    Resource mr;
+    std::vector<void*> pointers(state.range(0));
+
+    for (auto _ : perf::counted(state)) {
+        for (void*& ptr : pointers) {
+            ptr = mr.allocate(24, 8);
+        }
+        benchmark::DoNotOptimize(pointers.data());
+        for (void* ptr : pointers) {
+            mr.deallocate(ptr, 24, 8);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_SlabAllocateFree, unsynchronized_pool_resource)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_SlabAllocateFree, unsynchronized_slab_pool_resource)->Arg(1000)->Arg(10000);
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SGI_PMR_HAS_RDTSC 1
+#else
+#define SGI_PMR_HAS_RDTSC 0
+#endif
+
+namespace sgi_pmr::perf {
+
+/**
+ * @brief 单次操作计时用的时钟
+ *
+ * x86 上读取时间戳计数器（rdtsc，前置 lfence 防止与被测代码乱序），启动时对照 steady_clock
+ * 校准每个 tick 的纳秒数；其他平台直接使用 steady_clock。
+ */
+class latency_clock {
+public:
+    static std::uint64_t now() noexcept {
+#if SGI_PMR_HAS_RDTSC
+        _mm_lfence();
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /**
+     * @brief 每个 tick 的纳秒数，首次调用时校准
+     */
+    static double ns_per_tick() {
+        static const double value = calibrate();
+        return value;
+    }
+
+    /**
+     * @brief 连续两次读取时钟的最小间隔（tick），从测量值中扣除
+     */
+    static std::uint64_t overhead() {
+        static const std::uint64_t value = [] {
+            std::uint64_t best = UINT64_MAX;
+            for (int i = 0; i < 1000; ++i) {
+                std::uint64_t begin = now();
+                std::uint64_t end = now();
+                best = std::min(best, end - begin);
+            }
+            return best;
+        }();
+        return value;
+    }
+
+private:
+    static double calibrate() {
+#if SGI_PMR_HAS_RDTSC
+        auto wall_begin = std::chrono::steady_clock::now();
+        std::uint64_t begin = now();
+        while (std::chrono::steady_clock::now() - wall_begin < std::chrono::milliseconds(20)) {
+        }
+        std::uint64_t end = now();
+        auto wall = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - wall_begin);
+        return wall.count() / static_cast<double>(end - begin);
+#else
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::duration(1)).count();
+#endif
+    }
+};
+
+/**
+ * @brief HDR 风格的延迟直方图
+ *
+ * 小于 2^SUB_BITS 的值各占一个桶；更大的值按 2 的幂分段，每段再线性划分为 2^(SUB_BITS-1) 个桶，
+ * 相对误差不超过 1/2^(SUB_BITS-1)。记录只是一次数组自增，覆盖 uint64 的整个范围，
+ * 可以合并多个线程各自的直方图。最大值单独精确记录。
+ */
+class latency_histogram {
+public:
+    static constexpr unsigned SUB_BITS = 7;
+
+private:
+    static constexpr std::uint64_t LINEAR = std::uint64_t{1} << SUB_BITS;
+    static constexpr std::uint64_t HALF = LINEAR / 2;
+    static constexpr std::size_t BUCKETS = LINEAR + (64 - SUB_BITS) * HALF;
+
+    std::vector<std::uint64_t> counts_ = std::vector<std::uint64_t>(BUCKETS);
+    std::uint64_t total_ = 0;
+    std::uint64_t max_ = 0;
+
+    static std::size_t bucket(std::uint64_t value) noexcept {
+        if (value < LINEAR) return static_cast<std::size_t>(value);
+        unsigned shift = static_cast<unsigned>(std::bit_width(value)) - SUB_BITS;
+        return static_cast<std::size_t>(LINEAR + (shift - 1) * HALF + ((value >> shift) - HALF));
+    }
+
+    // 桶内的最大值，分位数按它报告，不会低估
+    static std::uint64_t bucket_upper(std::size_t index) noexcept {
+        if (index < LINEAR) return index;
+        std::size_t k = index - LINEAR;
+        unsigned shift = static_cast<unsigned>(k / HALF) + 1;
+        std::uint64_t low = (HALF + k % HALF) << shift;
+        return low + ((std::uint64_t{1} << shift) - 1);
+    }
+
+public:
+    void record(std::uint64_t value) noexcept {
+        ++counts_[bucket(value)];
+        ++total_;
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const latency_histogram& other) noexcept {
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    void clear() noexcept {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        max_ = 0;
+    }
+
+    std::uint64_t count() const noexcept { return total_; }
+    std::uint64_t max() const noexcept { return max_; }
+
+    /**
+     * @brief 至少 q 比例的记录不超过的值（q 在 0 到 1 之间），没有记录时为 0
+     */
+    std::uint64_t percentile(double q) const noexcept {
+        if (total_ == 0) return 0;
+        auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total_));
+        rank = std::clamp<std::uint64_t>(rank, 1, total_);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(bucket_upper(i), max_);
+        }
+        return max_;
+    }
+};
+
+} // namespace sgi_pmr::perf
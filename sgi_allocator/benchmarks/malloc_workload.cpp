@@ -0,0 +1,145 @@
+// 以 STL 容器为主的分配负载，不使用 pmr，也不依赖本库：
+// 用于比较 glibc malloc 与通过 LD_PRELOAD 或静态链接注入的 SGI 池（sgi_pmr_malloc）。
+//
+// 用法：
+//   sgi_pmr_malloc_workload [rounds] [threads]
+//
+// 每个阶段输出耗时（毫秒），最后一行为总耗时和校验和；校验和只依赖输入，
+// 不同分配器下必须一致。
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+std::string make_key(std::mt19937_64& rng) {
+    // 短字符串和超出 SSO 的长字符串混合
+    std::size_t length = 8 + rng() % 56;
+    std::string key(length, ' ');
+    for (char& c : key) {
+        c = static_cast<char>('a' + rng() % 26);
+    }
+    return key;
+}
+
+// 有序映射：随机插入、查找、删除一半后再插入
+std::uint64_t map_phase(std::mt19937_64& rng, std::size_t count) {
+    std::map<std::uint64_t, std::string> map;
+    for (std::size_t i = 0; i < count; ++i) {
+        map.emplace(rng() % (count * 4), make_key(rng));
+    }
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto it = map.find(rng() % (count * 4));
+        if (it != map.end()) sum += it->second.size();
+    }
+    for (auto it = map.begin(); it != map.end();) {
+        it = (it->first & 1) ? map.erase(it) : std::next(it);
+    }
+    for (std::size_t i = 0; i < count / 2; ++i) {
+        map.emplace(rng() % (count * 4), make_key(rng));
+    }
+    return sum + map.size();
+}
+
+// 哈希表：字符串键，反复扩容
+std::uint64_t hash_phase(std::mt19937_64& rng, std::size_t count) {
+    std::unordered_map<std::string, std::vector<int>> table;
+    for (std::size_t i = 0; i < count; ++i) {
+        table[make_key(rng)].push_back(static_cast<int>(i));
+    }
+    std::uint64_t sum = 0;
+    for (const auto& [key, values] : table) {
+        sum += key.size() + values.size();
+    }
+    return sum;
+}
+
+// 向量与字符串：追加导致的重新分配和拷贝
+std::uint64_t vector_phase(std::mt19937_64& rng, std::size_t count) {
+    std::vector<std::string> strings;
+    std::vector<std::vector<std::uint32_t>> vectors(64);
+    for (std::size_t i = 0; i < count; ++i) {
+        strings.push_back(make_key(rng));
+        vectors[i % vectors.size()].push_back(static_cast<std::uint32_t>(rng()));
+        if (strings.size() > 4096) {
+            strings.erase(strings.begin(), strings.begin() + 2048);
+        }
+    }
+    std::uint64_t sum = strings.size();
+    for (const auto& v : vectors) sum += v.size();
+    return sum;
+}
+
+// 链表与智能指针：大量同尺寸小对象的分配和释放
+std::uint64_t list_phase(std::mt19937_64& rng, std::size_t count) {
+    std::list<std::shared_ptr<std::string>> list;
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        list.push_back(std::make_shared<std::string>(make_key(rng)));
+        if (list.size() > 1024 && (rng() & 1)) {
+            sum += list.front()->size();
+            list.pop_front();
+        }
+    }
+    return sum + list.size();
+}
+
+struct phase {
+    const char* name;
+    std::uint64_t (*run)(std::mt19937_64&, std::size_t);
+    std::size_t count;
+};
+
+constexpr phase phases[] = {
+    {"map", map_phase, 100000},
+    {"unordered_map", hash_phase, 100000},
+    {"vector/string", vector_phase, 400000},
+    {"list/shared_ptr", list_phase, 200000},
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 3;
+    std::size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1;
+    if (rounds == 0 || threads == 0) {
+        std::fprintf(stderr, "usage: %s [rounds] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    auto total_start = clock_type::now();
+    std::uint64_t checksum = 0;
+    for (const phase& p : phases) {
+        auto start = clock_type::now();
+        std::vector<std::uint64_t> sums(threads);
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::mt19937_64 rng(t + 1);
+                for (std::size_t r = 0; r < rounds; ++r) {
+                    sums[t] += p.run(rng, p.count);
+                }
+            });
+        }
+        for (std::thread& w : workers) w.join();
+        for (std::uint64_t s : sums) checksum += s;
+
+        double ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+        std::printf("%-16s %10.1f ms\n", p.name, ms);
+    }
+    double total = std::chrono::duration<double, std::milli>(clock_type::now() - total_start).count();
+    std::printf("%-16s %10.1f ms  checksum %llu\n", "total", total, static_cast<unsigned long long>(checksum));
+    return 0;
+}
@@ -0,0 +1,221 @@
+#include "perf_counters.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define SGI_PMR_HAS_PERF_EVENT 1
+#else
+#define SGI_PMR_HAS_PERF_EVENT 0
+#endif
+
+namespace sgi_pmr::perf {
+
+namespace {
+
+#if SGI_PMR_HAS_PERF_EVENT
+
+struct event_spec {
+    const char* name;
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+// 缓存事件的编码：缓存 | 操作 << 8 | 结果 << 16
+constexpr std::uint64_t cache_read_miss(std::uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+constexpr event_spec events[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"l1d_misses", PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_L1D)},
+    {"llc_misses", PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_LL)},
+    {"dtlb_misses", PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_DTLB)},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    // 软件事件：首次访问新映射内存的缺页，没有硬件计数器的虚拟机中也可用
+    {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+constexpr std::size_t EVENT_COUNT = sizeof(events) / sizeof(events[0]);
+
+// SGI_PMR_PERF_COUNTERS 选中的事件，只在首次使用时解析
+struct selection {
+    bool enabled[EVENT_COUNT] = {};
+    bool any = false;
+
+    selection() {
+        const char* env = std::getenv("SGI_PMR_PERF_COUNTERS");
+        if (!env || !*env) return;
+
+        std::string list = env;
+        if (list == "all") {
+            list.clear();
+            for (const event_spec& e : events) {
+                list += e.name;
+                list += ',';
+            }
+        }
+
+        std::size_t begin = 0;
+        while (begin < list.size()) {
+            std::size_t end = list.find(',', begin);
+            if (end == std::string::npos) end = list.size();
+            std::string name = list.substr(begin, end - begin);
+            begin = end + 1;
+            if (name.empty()) continue;
+
+            bool found = false;
+            for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+                if (name == events[i].name) {
+                    enabled[i] = any = found = true;
+                }
+            }
+            if (!found) {
+                std::fprintf(stderr, "SGI_PMR_PERF_COUNTERS: unknown counter '%s' ignored\n", name.c_str());
+            }
+        }
+    }
+};
+
+const selection& selected() {
+    static const selection s;
+    return s;
+}
+
+// 每个事件只提示一次不可用；各线程可能同时打开计数器
+bool report_unavailable(std::size_t index) {
+    static std::atomic<bool> reported[EVENT_COUNT] = {};
+    return !reported[index].exchange(true, std::memory_order_relaxed);
+}
+
+int open_event(const event_spec& spec, bool inherit) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = inherit ? 1 : 0;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+#endif // SGI_PMR_HAS_PERF_EVENT
+
+// 当前线程 start 与 stop 之间的计数器
+thread_local counter_set* active_set = nullptr;
+
+} // namespace
+
+counter_set::counter_set([[maybe_unused]] scope s) {
+#if SGI_PMR_HAS_PERF_EVENT
+    const selection& sel = selected();
+    for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+        if (!sel.enabled[i]) continue;
+
+        int fd = open_event(events[i], s == scope::with_child_threads);
+        if (fd >= 0) {
+            counters_.push_back({events[i].name, fd});
+        } else if (report_unavailable(i)) {
+            std::fprintf(stderr, "perf counter %s unavailable (%s), skipped\n", events[i].name,
+                         std::strerror(errno));
+        }
+    }
+#endif
+}
+
+counter_set::~counter_set() {
+#if SGI_PMR_HAS_PERF_EVENT
+    for (const counter& c : counters_) {
+        close(c.fd);
+    }
+#endif
+}
+
+counter_set* counter_set::for_this_thread(scope s) {
+#if SGI_PMR_HAS_PERF_EVENT
+    if (!selected().any) return nullptr;
+
+    // 两种统计范围各自一组文件描述符，随线程退出关闭
+    thread_local std::unique_ptr<counter_set> sets[2];
+    std::unique_ptr<counter_set>& set = sets[s == scope::with_child_threads];
+    if (!set) {
+        set.reset(new counter_set(s));
+    }
+    return set->counters_.empty() ? nullptr : set.get();
+#else
+    (void)s;
+    return nullptr;
+#endif
+}
+
+void counter_set::start() noexcept {
+#if SGI_PMR_HAS_PERF_EVENT
+    for (const counter& c : counters_) {
+        ioctl(c.fd, PERF_EVENT_IOC_RESET, 0);
+    }
+    for (const counter& c : counters_) {
+        ioctl(c.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    active_set = this;
+}
+
+void counter_set::pause() noexcept {
+#if SGI_PMR_HAS_PERF_EVENT
+    for (const counter& c : counters_) {
+        ioctl(c.fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+#endif
+}
+
+void counter_set::resume() noexcept {
+#if SGI_PMR_HAS_PERF_EVENT
+    for (const counter& c : counters_) {
+        ioctl(c.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+counter_set* counter_set::active() noexcept {
+    return active_set;
+}
+
+void counter_set::stop([[maybe_unused]] benchmark::State& state) noexcept {
+    active_set = nullptr;
+#if SGI_PMR_HAS_PERF_EVENT
+    for (const counter& c : counters_) {
+        ioctl(c.fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    double cycles = 0, instructions = 0;
+    for (const counter& c : counters_) {
+        // 计数器多于硬件寄存器时内核轮流调度，按实际运行时间的比例放大
+        std::uint64_t values[3];
+        if (read(c.fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[2] == 0) {
+            continue;
+        }
+        double value = static_cast<double>(values[0]) * static_cast<double>(values[1]) /
+                       static_cast<double>(values[2]);
+        state.counters[c.name] = benchmark::Counter(value, benchmark::Counter::kAvgIterations);
+
+        if (std::strcmp(c.name, "cycles") == 0) cycles = value;
+        if (std::strcmp(c.name, "instructions") == 0) instructions = value;
+    }
+    if (cycles > 0 && instructions > 0) {
+        state.counters["ipc"] = benchmark::Counter(instructions / cycles, benchmark::Counter::kAvgThreads);
+    }
+#endif
+}
+
+} // namespace sgi_pmr::perf
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+namespace sgi_pmr::perf {
+
+/**
+ * @brief 基准测试的硬件性能计数器（Linux perf_event_open）
+ *
+ * 环境变量 SGI_PMR_PERF_COUNTERS 为 all 时采集全部计数器，也可以用逗号分隔选择其中一部分：
+ * cycles、instructions、l1d_misses、llc_misses、dtlb_misses、branch_misses、page_faults。
+ * 未设置时不打开任何计数器，基准循环与直接遍历 State 相同。
+ *
+ * 计数器只统计用户态，在计时开始后启用、计时结束后停止。循环内不计时的部分用 perf::pause 和
+ * perf::resume 代替 State::PauseTiming 和 ResumeTiming，计数器随计时一起暂停。结果以每次迭代的平均值
+ * 作为 Google Benchmark 的用户计数器输出；同时有 cycles 和 instructions 时额外输出 ipc。
+ * 容器或虚拟机中不支持的计数器在首次打开失败时提示一次并跳过，不影响基准测试本身。
+ */
+class counter_set {
+public:
+    // 被测代码所在的线程
+    enum class scope {
+        calling_thread,         // 只统计调用线程；多线程基准中每个线程各自统计，结果由框架累加
+        with_child_threads      // 同时统计计时期间创建并已结束的子线程，用于自行创建线程的基准
+    };
+
+    counter_set(const counter_set&) = delete;
+    counter_set& operator=(const counter_set&) = delete;
+    ~counter_set();
+
+    /**
+     * @brief 当前线程的计数器，首次调用时打开；未开启采集或没有可用计数器时返回 nullptr
+     */
+    static counter_set* for_this_thread(scope s);
+
+    /**
+     * @brief 清零并启用全部计数器
+     */
+    void start() noexcept;
+
+    /**
+     * @brief 停止计数并把结果写入 state.counters
+     */
+    void stop(benchmark::State& state) noexcept;
+
+    /**
+     * @brief 暂停和恢复计数，不清零
+     */
+    void pause() noexcept;
+    void resume() noexcept;
+
+    /**
+     * @brief 当前线程正在计数的计数器（start 与 stop 之间），没有时返回 nullptr
+     */
+    static counter_set* active() noexcept;
+
+private:
+    struct counter {
+        const char* name;
+        int fd;
+    };
+
+    std::vector<counter> counters_;
+
+    explicit counter_set(scope s);
+};
+
+/**
+ * @brief 带计数器的基准循环：for (auto _ : perf::counted(state)) { ... }
+ */
+class counted_range {
+public:
+    class iterator {
+    public:
+        iterator(benchmark::State::StateIterator it, counted_range* range) : it_(it), range_(range) {}
+
+        auto operator*() const { return *it_; }
+
+        iterator& operator++() {
+            ++it_;
+            return *this;
+        }
+
+        bool operator!=(const iterator& other) const {
+            if (it_ != other.it_) [[likely]] return true;
+            range_->finish();
+            return false;
+        }
+
+    private:
+        benchmark::State::StateIterator it_;
+        counted_range* range_;
+    };
+
+    counted_range(benchmark::State& state, counter_set::scope s)
+        : state_(state), counters_(counter_set::for_this_thread(s)) {}
+
+    iterator begin() { return iterator(state_.begin(), this); }
+
+    // State::end() 开始计时，计数器随后启用
+    iterator end() {
+        iterator it(state_.end(), this);
+        if (counters_) counters_->start();
+        return it;
+    }
+
+private:
+    benchmark::State& state_;
+    counter_set* counters_;
+
+    void finish() noexcept {
+        if (counters_) counters_->stop(state_);
+    }
+};
+
+inline counted_range counted(benchmark::State& state,
+                             counter_set::scope s = counter_set::scope::calling_thread) {
+    return counted_range(state, s);
+}
+
+/**
+ * @brief 暂停计时和计数器，用于循环内不计入结果的准备和清理
+ */
+inline void pause(benchmark::State& state) {
+    if (counter_set* c = counter_set::active()) c->pause();
+    state.PauseTiming();
+}
+
+/**
+ * @brief 恢复计时和计数器
+ */
+inline void resume(benchmark::State& state) {
+    state.ResumeTiming();
+    if (counter_set* c = counter_set::active()) c->resume();
+}
+
+} // namespace sgi_pmr::perf
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <random>
+
+namespace sgi_pmr::perf {
+
+/**
+ * @brief 8 到 max_bytes 之间按对数均匀分布的大小，小对象占多数
+ *
+ * 先在 [8, 16]、[16, 32]、... 这些不超过 max_bytes 的段中均匀选一段，再在该段内均匀取值，
+ * 各基准测试用同一分布生成混合大小的请求，结果可以相互比较。max_bytes 不小于 16。
+ */
+inline std::size_t random_size(std::mt19937& rng, std::size_t max_bytes) {
+    std::size_t segments = std::bit_width(max_bytes) - 4;
+    std::size_t lower = std::size_t{8} << (rng() % segments);
+    return lower + rng() % (lower + 1);
+}
+
+} // namespace sgi_pmr::perf
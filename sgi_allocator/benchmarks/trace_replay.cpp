@@ -0,0 +1,296 @@
+// 分配轨迹重放工具：把 recording_resource 记录的轨迹依次在各个内存资源上重放，
+// 报告吞吐量、分配和释放的延迟分位数以及向上游申请内存的峰值。
+//
+// 用法：
+//   sgi_pmr_trace_replay <trace> [--threads] [--resource <name>]...
+//   sgi_pmr_trace_replay --generate <trace> <operations>
+//
+// --threads 时每个记录中的线程在各自的线程上重放，跨线程释放会等待对应的分配完成；
+// 否则按记录顺序在单个线程上重放。--generate 生成一条混合大小的合成轨迹，便于试用。
+
+#include "../include/sgi_pmr_allocator.hpp"
+#include "../include/sgi_pmr_thread_cache.hpp"
+#include "../include/sgi_pmr_lockfree.hpp"
+#include "../include/sgi_pmr_sharded.hpp"
+#include "../include/sgi_pmr_thread_heap.hpp"
+#include "../include/sgi_pmr_trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sgi_pmr;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// 统计向上游申请的字节数及其峰值，作为各资源的内存占用
+class footprint_resource : public std::pmr::memory_resource {
+public:
+    std::atomic<std::size_t> current{0};
+    std::atomic<std::size_t> peak{0};
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        std::size_t now = current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        std::size_t old_peak = peak.load(std::memory_order_relaxed);
+        while (now > old_peak && !peak.compare_exchange_weak(old_peak, now, std::memory_order_relaxed)) {
+        }
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        current.fetch_sub(bytes, std::memory_order_relaxed);
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+struct resource_factory {
+    const char* name;
+    bool thread_safe;
+    // 返回 nullptr 表示直接使用上游（即默认的 new/delete 资源）
+    std::function<std::unique_ptr<std::pmr::memory_resource>(std::pmr::memory_resource*)> make;
+};
+
+template <typename Resource>
+resource_factory factory(const char* name, bool thread_safe = true) {
+    return {name, thread_safe, [](std::pmr::memory_resource* upstream) -> std::unique_ptr<std::pmr::memory_resource> {
+                return std::make_unique<Resource>(upstream);
+            }};
+}
+
+std::vector<resource_factory> all_resources() {
+    return {
+        factory<synchronized_pool_resource>("sgi_pmr::synchronized_pool_resource"),
+        factory<unsynchronized_pool_resource>("sgi_pmr::unsynchronized_pool_resource", false),
+        factory<thread_cached_pool_resource>("sgi_pmr::thread_cached_pool_resource"),
+        factory<lockfree_pool_resource>("sgi_pmr::lockfree_pool_resource"),
+        factory<sharded_pool_resource>("sgi_pmr::sharded_pool_resource"),
+        factory<thread_heap_pool_resource>("sgi_pmr::thread_heap_pool_resource"),
+        factory<std::pmr::synchronized_pool_resource>("std::pmr::synchronized_pool_resource"),
+        factory<std::pmr::unsynchronized_pool_resource>("std::pmr::unsynchronized_pool_resource", false),
+        {"new_delete_resource", true, [](std::pmr::memory_resource*) { return std::unique_ptr<std::pmr::memory_resource>(); }},
+    };
+}
+
+// 单次重放的结果
+struct replay_result {
+    double seconds = 0;
+    std::vector<std::uint32_t> allocate_ns;
+    std::vector<std::uint32_t> deallocate_ns;
+};
+
+std::uint32_t elapsed_ns(clock_type::time_point begin, clock_type::time_point end) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    return static_cast<std::uint32_t>(std::min<long long>(ns, UINT32_MAX));
+}
+
+// 对象编号对应的地址，跨线程释放时等待分配方写入
+struct object_slot {
+    std::atomic<void*> pointer{nullptr};
+};
+
+void replay_records(std::pmr::memory_resource& mr, const std::vector<const trace_record*>& records,
+                    std::vector<object_slot>& slots, replay_result& result) {
+    result.allocate_ns.reserve(records.size());
+    result.deallocate_ns.reserve(records.size());
+
+    for (const trace_record* r : records) {
+        object_slot& slot = slots[r->id];
+        if (r->op == trace_op::allocate) {
+            auto begin = clock_type::now();
+            void* p = mr.allocate(r->size, r->alignment());
+            auto end = clock_type::now();
+            result.allocate_ns.push_back(elapsed_ns(begin, end));
+
+            // 像真实负载一样触碰对象
+            if (r->size) {
+                static_cast<char*>(p)[0] = 1;
+            }
+            slot.pointer.store(p, std::memory_order_release);
+        } else {
+            void* p;
+            while (!(p = slot.pointer.load(std::memory_order_acquire))) {
+                std::this_thread::yield();
+            }
+            slot.pointer.store(nullptr, std::memory_order_relaxed);
+
+            auto begin = clock_type::now();
+            mr.deallocate(p, r->size, r->alignment());
+            auto end = clock_type::now();
+            result.deallocate_ns.push_back(elapsed_ns(begin, end));
+        }
+    }
+}
+
+replay_result replay(std::pmr::memory_resource& mr, const std::vector<trace_record>& trace,
+                     std::size_t object_count, bool threaded) {
+    std::vector<object_slot> slots(object_count);
+    replay_result result;
+
+    // 按线程划分记录，单线程模式下所有记录属于同一组
+    std::vector<std::vector<const trace_record*>> groups(1);
+    for (const trace_record& r : trace) {
+        std::size_t group = threaded ? r.thread : 0;
+        if (group >= groups.size()) {
+            groups.resize(group + 1);
+        }
+        groups[group].push_back(&r);
+    }
+
+    std::vector<replay_result> partial(groups.size());
+    auto begin = clock_type::now();
+    if (groups.size() == 1) {
+        replay_records(mr, groups[0], slots, partial[0]);
+    } else {
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < groups.size(); ++i) {
+            threads.emplace_back([&, i]() { replay_records(mr, groups[i], slots, partial[i]); });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    result.seconds = std::chrono::duration<double>(clock_type::now() - begin).count();
+
+    // 轨迹结束时仍存活的对象在计时之外释放
+    for (const trace_record& r : trace) {
+        if (r.op != trace_op::allocate) continue;
+        if (void* p = slots[r.id].pointer.exchange(nullptr)) {
+            mr.deallocate(p, r.size, r.alignment());
+        }
+    }
+
+    for (const replay_result& p : partial) {
+        result.allocate_ns.insert(result.allocate_ns.end(), p.allocate_ns.begin(), p.allocate_ns.end());
+        result.deallocate_ns.insert(result.deallocate_ns.end(), p.deallocate_ns.begin(), p.deallocate_ns.end());
+    }
+    return result;
+}
+
+std::uint32_t percentile(std::vector<std::uint32_t>& values, double q) {
+    if (values.empty()) return 0;
+    std::size_t k = std::min(values.size() - 1, static_cast<std::size_t>(q * values.size()));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+// 生成合成轨迹：大小近似对数均匀分布在 8 字节到 4KB，存活对象数在上限附近波动
+void generate(const std::string& path, std::size_t operations) {
+    recording_resource recorder(path, std::pmr::new_delete_resource());
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> log_size(3.0, 12.0);
+    std::bernoulli_distribution aligned(0.05);
+    std::vector<std::pair<void*, std::pair<std::size_t, std::size_t>>> live;
+    constexpr std::size_t MAX_LIVE = 10000;
+
+    for (std::size_t i = 0; i < operations; ++i) {
+        // 分配略多于释放，使存活对象数逐步增长到上限
+        bool do_free = !live.empty() && (live.size() >= MAX_LIVE || rng() % 100 < 45);
+        if (do_free) {
+            std::size_t k = rng() % live.size();
+            std::swap(live[k], live.back());
+            recorder.deallocate(live.back().first, live.back().second.first, live.back().second.second);
+            live.pop_back();
+        } else {
+            std::size_t size = static_cast<std::size_t>(std::exp2(log_size(rng)));
+            std::size_t alignment = aligned(rng) ? 64 : alignof(std::max_align_t);
+            live.push_back({recorder.allocate(size, alignment), {size, alignment}});
+        }
+    }
+    for (const auto& object : live) {
+        recorder.deallocate(object.first, object.second.first, object.second.second);
+    }
+}
+
+int usage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s <trace> [--threads] [--resource <name>]...\n"
+                 "       %s --generate <trace> <operations>\n",
+                 program, program);
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "--generate") == 0) {
+        if (argc != 4) return usage(argv[0]);
+        generate(argv[2], std::strtoull(argv[3], nullptr, 10));
+        return 0;
+    }
+    if (argc < 2) return usage(argv[0]);
+
+    std::string path = argv[1];
+    bool threaded = false;
+    std::vector<std::string> selected;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0) {
+            threaded = true;
+        } else if (std::strcmp(argv[i], "--resource") == 0 && i + 1 < argc) {
+            selected.push_back(argv[++i]);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    std::vector<trace_record> trace;
+    try {
+        trace = read_trace(path);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    std::size_t object_count = 0;
+    for (const trace_record& r : trace) {
+        object_count = std::max<std::size_t>(object_count, r.id + 1);
+    }
+    std::printf("%s: %zu operations, %zu objects%s\n\n", path.c_str(), trace.size(), object_count,
+                threaded ? ", threaded replay" : "");
+    std::printf("%-40s %10s %8s %8s %8s %8s %8s %8s %10s\n", "resource", "Mops/s",
+                "a.p50", "a.p99", "a.p999", "f.p50", "f.p99", "f.p999", "peak MB");
+
+    for (const resource_factory& f : all_resources()) {
+        if (!selected.empty() && std::find(selected.begin(), selected.end(), f.name) == selected.end()) {
+            continue;
+        }
+        // 非同步资源不能多线程重放
+        if (threaded && !f.thread_safe) {
+            continue;
+        }
+
+        footprint_resource upstream;
+        replay_result result;
+        {
+            std::unique_ptr<std::pmr::memory_resource> mr = f.make(&upstream);
+            result = replay(mr ? *mr : upstream, trace, object_count, threaded);
+        }
+
+        std::printf("%-40s %10.2f %8u %8u %8u %8u %8u %8u %10.2f\n", f.name,
+                    trace.size() / result.seconds / 1e6,
+                    percentile(result.allocate_ns, 0.5), percentile(result.allocate_ns, 0.99),
+                    percentile(result.allocate_ns, 0.999),
+                    percentile(result.deallocate_ns, 0.5), percentile(result.deallocate_ns, 0.99),
+                    percentile(result.deallocate_ns, 0.999),
+                    upstream.peak.load() / double(1 << 20));
+    }
+    std::printf("\nlatencies in ns (a = allocate, f = deallocate)\n");
+    return 0;
+}
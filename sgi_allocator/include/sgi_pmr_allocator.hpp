@@ -3,83 +3,891 @@
 #include <memory_resource>
 #include <cstddef>
 #include <cstdlib>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <vector>
 #include <mutex>
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include "sgi_pmr_page.hpp"
 
 namespace sgi_pmr {
 
+// 定义在 sgi_pmr_profiler.hpp 中，启用 pool_options::sample_interval_bytes 时需要包含
+class heap_profiler;
+
+/**
+ * @brief 大小类的间隔方式
+ */
+enum class size_class_spacing {
+    linear,     // 每隔 alignment 字节一个大小类
+    geometric   // 每次翻倍划分为 4 个大小类
+};
+
+/**
+ * @brief 内存池的编译期配置
+ *
+ * 作为模板实参传给各个池资源，用法类似 std::pmr::pool_options，例如：
+ * basic_synchronized_pool_resource<pool_options{.max_bytes = 512, .spacing = size_class_spacing::geometric}>
+ */
+struct pool_options {
+    // 对齐要求，也是最小的大小类
+    std::size_t alignment = 8;
+
+    // 小对象分配的最大大小，超过时直接使用系统分配
+    std::size_t max_bytes = 128;
+
+    // 大小类的间隔方式
+    size_class_spacing spacing = size_class_spacing::linear;
+
+    // 每次 refill 切分的对象数；启用自适应批量时是每个大小类的初始值
+    std::size_t refill_batch = 20;
+
+    // 自适应 refill 批量的下限和上限，两者相等（默认）时批量固定为 refill_batch
+    std::size_t min_refill_batch = refill_batch;
+    std::size_t max_refill_batch = refill_batch;
+
+    // 池化的最大对齐，alignment 到该值之间的每个 2 的幂对齐各有一组大小类
+    std::size_t max_pooled_alignment = 64;
+
+    // 内存块完全空闲超过该毫秒数后自动归还上游，0 表示不自动衰减
+    std::size_t decay_ms = 0;
+
+    // 是否收集分配统计，关闭时计数器不占空间也不产生任何指令
+    bool enable_stats = false;
+
+    // 堆采样的平均间隔（字节），非零时各分配路径按此间隔抽取分配并记录调用栈，0 表示不采样。
+    // 启用时需要包含 sgi_pmr_profiler.hpp
+    std::size_t sample_interval_bytes = 0;
+
+    // 是否按大小类划分内存块并登记页映射，开启后可以不带大小释放、在 O(1) 内判断对象归属。
+    // 启用时需要包含 sgi_pmr_page_map.hpp
+    bool size_class_spans = false;
+
+    // 中等对象层的最大大小，0 表示不启用。大于 max_bytes 时，max_bytes 到该值之间按几何间隔再划分大小类，
+    // 对象从按页对齐的 span 中切分；小对象仍使用 spacing 指定的大小类
+    std::size_t medium_max_bytes = 0;
+};
+
+/**
+ * @brief 单个大小类的统计快照
+ */
+struct size_class_stats {
+    std::size_t bytes = 0;              // 对象大小
+    std::size_t alignment = 0;          // 对象对齐
+    std::uint64_t allocations = 0;      // 分配次数
+    std::uint64_t deallocations = 0;    // 释放次数
+    std::uint64_t refills = 0;          // refill 次数
+    std::size_t refill_batch = 0;       // 下一次 refill 的基准批量
+    std::uint64_t high_water = 0;       // 同时在使用的对象数的峰值
+    std::size_t free_list_length = 0;   // 空闲链表中的对象数
+};
+
+/**
+ * @brief 池资源的统计快照
+ */
+struct pool_stats {
+    std::vector<size_class_stats> size_classes;
+
+    std::uint64_t large_allocations = 0;    // 直接交给上游的大对象分配次数
+    std::uint64_t large_deallocations = 0;  // 大对象释放次数
+    std::size_t large_bytes = 0;            // 在使用的大对象字节数
+
+    std::size_t chunk_count = 0;            // 持有的内存块数量
+    std::size_t held_bytes = 0;             // 持有的内存块总字节数
+    std::size_t free_bytes = 0;             // 内存块中空闲的字节数（空闲链表与内存池剩余区间）
+
+    /**
+     * @brief 碎片率：内存块中空闲字节占持有字节的比例
+     */
+    double fragmentation_ratio() const noexcept {
+        return held_bytes ? static_cast<double>(free_bytes) / static_cast<double>(held_bytes) : 0.0;
+    }
+};
+
+namespace detail {
+
+/**
+ * @brief 根据配置在编译期生成大小类表和大小到大小类的查找表
+ */
+template <pool_options Options>
+struct size_class_table {
+    static_assert(Options.alignment >= sizeof(void*) && std::has_single_bit(Options.alignment),
+                  "alignment must be a power of two no smaller than a pointer");
+    static_assert(Options.max_bytes >= Options.alignment && Options.max_bytes % Options.alignment == 0,
+                  "max_bytes must be a positive multiple of alignment");
+    static_assert(Options.min_refill_batch > 0, "refill_batch must be positive");
+    static_assert(Options.min_refill_batch <= Options.refill_batch && Options.refill_batch <= Options.max_refill_batch,
+                  "refill_batch must lie within [min_refill_batch, max_refill_batch]");
+    static_assert(Options.max_refill_batch <= (std::size_t{1} << 20), "max_refill_batch is too large");
+    static_assert(std::has_single_bit(Options.max_pooled_alignment),
+                  "max_pooled_alignment must be a power of two");
+    static_assert(Options.medium_max_bytes == 0 ||
+                  (Options.medium_max_bytes > Options.max_bytes && Options.medium_max_bytes % Options.alignment == 0),
+                  "medium_max_bytes must be a multiple of alignment larger than max_bytes");
+
+    // 是否启用中等对象层
+    static constexpr bool has_medium = Options.medium_max_bytes > 0;
+
+    // 池化的最大大小
+    static constexpr std::size_t max_bytes = has_medium ? Options.medium_max_bytes : Options.max_bytes;
+
+    /**
+     * @brief 按间隔方式依次生成每个大小类，小对象层的最后一个大小类总是 max_bytes；
+     * 中等对象层从 max_bytes 开始每次翻倍划分为 4 个大小类，最后一个大小类是 medium_max_bytes
+     */
+    template <typename F>
+    static constexpr void for_each_class(F f) {
+        std::size_t size = Options.alignment;
+        while (size < Options.max_bytes) {
+            f(size);
+            std::size_t step = Options.alignment;
+            if (Options.spacing == size_class_spacing::geometric) {
+                step = std::max(Options.alignment, std::bit_floor(size) / 4);
+            }
+            size += step;
+        }
+        f(Options.max_bytes);
+
+        if constexpr (has_medium) {
+            size = Options.max_bytes;
+            while (true) {
+                size += std::max(Options.alignment, std::bit_floor(size) / 4);
+                if (size >= Options.medium_max_bytes) break;
+                f(size);
+            }
+            f(Options.medium_max_bytes);
+        }
+    }
+
+    // 大小类数量
+    static constexpr std::size_t count = [] {
+        std::size_t n = 0;
+        for_each_class([&n](std::size_t) { ++n; });
+        return n;
+    }();
+
+    // 每个大小类的对象大小，升序
+    static constexpr std::array<std::size_t, count> sizes = [] {
+        std::array<std::size_t, count> result{};
+        std::size_t i = 0;
+        for_each_class([&](std::size_t size) { result[i++] = size; });
+        return result;
+    }();
+
+    // 小对象层的大小类数量，之后的大小类属于中等对象层
+    static constexpr std::size_t small_count = [] {
+        std::size_t n = 0;
+        while (n < count && sizes[n] <= Options.max_bytes) {
+            ++n;
+        }
+        return n;
+    }();
+
+    using index_type = std::conditional_t<(count <= 256), std::uint8_t, std::uint16_t>;
+
+    // 以 (bytes + alignment - 1) / alignment 为下标的大小类查找表
+    static constexpr std::array<index_type, max_bytes / Options.alignment + 1> index = [] {
+        std::array<index_type, max_bytes / Options.alignment + 1> result{};
+        std::size_t c = 0;
+        for (std::size_t slot = 0; slot < result.size(); ++slot) {
+            while (sizes[c] < slot * Options.alignment) {
+                ++c;
+            }
+            result[slot] = static_cast<index_type>(c);
+        }
+        return result;
+    }();
+
+    // 对齐层数：第 t 层服务 alignment << t 对齐的请求
+    static constexpr std::size_t tier_count =
+        Options.max_pooled_alignment > Options.alignment
+            ? std::countr_zero(Options.max_pooled_alignment) - std::countr_zero(Options.alignment) + 1
+            : 1;
+
+    // 第 t 层第 i 个大小类的对象大小为 sizes[i] 向上取整到该层对齐
+    static constexpr std::array<std::size_t, tier_count * count> tier_sizes = [] {
+        std::array<std::size_t, tier_count * count> result{};
+        for (std::size_t t = 0; t < tier_count; ++t) {
+            std::size_t align = Options.alignment << t;
+            for (std::size_t i = 0; i < count; ++i) {
+                result[t * count + i] = (sizes[i] + align - 1) & ~(align - 1);
+            }
+        }
+        return result;
+    }();
+};
+
+/**
+ * @brief 统计计数器
+ *
+ * add 供已被外部同步的唯一写者使用（锁内或线程私有），编译为普通的读改写，没有 lock 前缀；
+ * atomic_add 供多个线程同时写入。读取方可以在任意线程无锁读取。
+ */
+class stat_counter {
+    std::atomic<std::uint64_t> value_{0};
+
+public:
+    void add(std::uint64_t n = 1) noexcept {
+        value_.store(value_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    void sub(std::uint64_t n = 1) noexcept {
+        value_.store(value_.load(std::memory_order_relaxed) - n, std::memory_order_relaxed);
+    }
+
+    void atomic_add(std::uint64_t n = 1) noexcept {
+        value_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void set(std::uint64_t n) noexcept {
+        value_.store(n, std::memory_order_relaxed);
+    }
+
+    std::uint64_t load() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+};
+
+// 关闭统计时代替计数器的空类型，配合 [[no_unique_address]] 不占空间
+struct no_stats {
+    no_stats() = default;
+
+    // 与被替代的状态类型使用相同的构造参数
+    template <typename... Args>
+    explicit constexpr no_stats(Args&&...) noexcept {}
+};
+
+// 按大小类划分内存块时的页映射。定义在类外，池的显式实例化（包括 extern template）
+// 不会实例化它，未启用 size_class_spans 时不需要包含 sgi_pmr_page_map.hpp
+template <typename Info>
+struct span_state {
+    // 页映射的节点同样来自上游
+    explicit span_state(std::pmr::memory_resource* upstream) : pages(upstream) {}
+
+    page_map<Info> pages;
+};
+
+// 依赖于模板参数的类型别名，推迟到实例化时才要求 T 是完整类型，
+// 未启用对应功能的池不需要包含定义 T 的头文件
+template <typename T, auto>
+struct deferred {
+    using type = T;
+};
+
+} // namespace detail
+
 /**
  * @brief SGI风格内存池资源基类
  *
  * 此类包含内存池的通用功能，
  * 但不直接继承自 std::pmr::memory_resource。
+ * 大小类、对齐和 refill 批量由模板参数 Options 在编译期确定。
  */
-class sgi_pool_resource_base {
+template <pool_options Options = pool_options{}>
+class basic_sgi_pool_resource_base {
 protected:
+    using table = detail::size_class_table<Options>;
+
     // 空闲链表节点结构
     union obj {
         union obj* free_list_link;
         char client_data[1];
     };
 
-    // 不同大小类的空闲链表数量
-    static constexpr std::size_t NFREELISTS = 16;
-    
+    // 不同大小类的空闲链表数量（所有对齐层之和）
+    static constexpr std::size_t NFREELISTS = table::tier_count * table::count;
+
     // 对齐要求
-    static constexpr std::size_t ALIGN = 8;
-    
-    // 小对象分配的最大大小
-    static constexpr std::size_t MAX_BYTES = 128;
+    static constexpr std::size_t ALIGN = Options.alignment;
+
+    // 池化的最大对齐，内存块按此对齐申请
+    static constexpr std::size_t MAX_ALIGN = ALIGN << (table::tier_count - 1);
+
+    // 池化分配的最大大小，启用中等对象层时为 medium_max_bytes
+    static constexpr std::size_t MAX_BYTES = table::max_bytes;
+
+    // 是否按大小类划分内存块
+    static constexpr bool SPANS = Options.size_class_spans;
+    static_assert(!SPANS || NFREELISTS < 0xFFFF, "too many size classes for the page map");
+
+    // 是否启用中等对象层
+    static constexpr bool MEDIUM = table::has_medium;
+
+    // 内存块的申请对齐；按大小类划分时按页对齐，使页映射覆盖整个块；
+    // 启用中等对象层时同样按页对齐，中等对象的 span 从块首切分不产生空隙
+    static constexpr std::size_t CHUNK_ALIGN = SPANS || MEDIUM ? std::max(MAX_ALIGN, detail::PAGE_SIZE) : MAX_ALIGN;
+
+    // 中等对象的 span 至少包含的字节数和对象数
+    static constexpr std::size_t MEDIUM_SPAN_BYTES = std::size_t{64} << 10;
+    static constexpr std::size_t MEDIUM_SPAN_OBJECTS = 8;
+
+    // 中等对象每次 refill 最多切分的字节数，大对象每次只切分少量，避免一次链接过多内存
+    static constexpr std::size_t MEDIUM_REFILL_BYTES = std::size_t{16} << 10;
+
+    // 向上游申请的内存块
+    struct chunk {
+        char* data;
+        std::size_t bytes;
+
+        // 最近一次扫描发现该块完全空闲的时间，默认值表示未空闲
+        std::chrono::steady_clock::time_point idle_since{};
+    };
+
+    // 启用衰减时每隔多少次释放检查一次时钟
+    static constexpr std::size_t DECAY_CHECK_INTERVAL = 1024;
 
     // 空闲链表数组
     obj* free_lists[NFREELISTS];
-    
-    // 内存池块
-    std::vector<char*> memory_chunks;
+
+    // 上游内存资源，内存块和大对象都从这里分配
+    std::pmr::memory_resource* upstream_;
+
+    // 内存池块，自身的存储同样来自上游
+    std::pmr::vector<chunk> memory_chunks;
+
+    // release_free_chunks 统计每个块空闲字节数用的表，随 memory_chunks 在分配路径上预先扩容，
+    // 扫描时不再分配，衰减可以安全地在释放路径上触发
+    std::pmr::vector<std::size_t> chunk_free_bytes;
+
+    // 内存池中尚未切分的区间 [start_free, end_free)
+    char* start_free;
+    char* end_free;
+
+    // 当前持有的内存块总字节数，用于几何增长
+    std::size_t heap_size;
+
+    // 衰减检查的计数和上次扫描时间
+    std::size_t decay_countdown = DECAY_CHECK_INTERVAL;
+    std::chrono::steady_clock::time_point last_decay;
+
+    // 每个大小类的计数器
+    struct class_counters {
+        detail::stat_counter allocations;
+        detail::stat_counter deallocations;
+        detail::stat_counter refills;
+        detail::stat_counter high_water;
+    };
+
+    struct stats_counters {
+        class_counters classes[NFREELISTS];
+        detail::stat_counter large_allocations;
+        detail::stat_counter large_deallocations;
+        detail::stat_counter large_bytes;
+    };
+
+    // 统计计数器，Options.enable_stats 为 false 时是空类型
+    [[no_unique_address]] std::conditional_t<Options.enable_stats, stats_counters, detail::no_stats> counters;
+
+    // 是否按大小类自适应调整 refill 批量
+    static constexpr bool ADAPTIVE_REFILL = Options.min_refill_batch < Options.max_refill_batch;
+
+    // 衡量 refill 是否频繁的窗口，以整个池的 refill 次数计
+    static constexpr std::size_t REFILL_WINDOW = 16;
+
+    // 自适应批量的状态，只在 refill 时读写，不影响分配和释放的快速路径
+    struct refill_state {
+        std::size_t batches[NFREELISTS];
+        std::size_t last_refill[NFREELISTS];    // 大小类最近一次 refill 的序号，0 表示尚未 refill
+        std::size_t refill_count = 0;           // 整个池的 refill 次数
+    };
+
+    // Options.min_refill_batch 等于 max_refill_batch 时是空类型
+    [[no_unique_address]] std::conditional_t<ADAPTIVE_REFILL, refill_state, detail::no_stats> refill_batches;
+
+    /**
+     * @brief 计算索引为 index 的大小类本次 refill 切分的对象数，并更新自适应状态
+     *
+     * 距上次 refill 不超过 REFILL_WINDOW 次（整个池计）时批量翻倍；
+     * 距离超过两个窗口说明上次切分的对象长时间没有用完，每多一个窗口批量减半。
+     */
+    std::size_t next_refill_batch(std::size_t index) noexcept;
+
+    // 是否对分配采样
+    static constexpr bool SAMPLING = Options.sample_interval_bytes > 0;
+
+    struct sampler_state {
+        std::ptrdiff_t bytes_until_sample;  // 减到 0 以下时抽取当前分配
+        std::uint64_t rng;                  // 采样间隔的随机数状态
+    };
+
+    // Options.sample_interval_bytes 为 0 时是空类型
+    [[no_unique_address]] std::conditional_t<SAMPLING, sampler_state, detail::no_stats> sampler;
+
+    // 只在启用采样时使用，不采样的池不需要 heap_profiler 的定义
+    using profiler = typename detail::deferred<heap_profiler, Options>::type;
+
+    /**
+     * @brief 把被抽中的分配登记到 heap_profiler::global()，并生成下一个采样间隔
+     */
+    void sample_allocation(void* p, std::size_t bytes) requires (SAMPLING);
+
+    /**
+     * @brief 按分配的字节数推进采样计数，越过间隔时抽取该分配
+     */
+    void advance_sampler(void* p, std::size_t bytes) requires (SAMPLING) {
+        sampler.bytes_until_sample -= static_cast<std::ptrdiff_t>(bytes);
+        if (sampler.bytes_until_sample < 0) {
+            sample_allocation(p, bytes);
+        }
+    }
+
+    // 页映射中记录的页归属，全为 0 表示不属于本资源
+    struct page_info {
+        std::uint32_t large_pages;  // 大对象占用的页数，只记录在大对象的首页
+        std::uint16_t index;        // 池化页所属大小类的索引加一
+        std::uint8_t align_log2;    // 大对象向上游申请时的对齐
+        std::uint8_t reserved;
+    };
+
+    // Options.size_class_spans 为 false 时是空类型
+    [[no_unique_address]] std::conditional_t<SPANS, detail::span_state<page_info>, detail::no_stats> spans;
+
+    // 每个大小类当前 span 中尚未切分的区间
+    struct cursor_state {
+        char* cursors[NFREELISTS];
+        char* ends[NFREELISTS];
+    };
+
+    // 既不按大小类划分内存块、也不启用中等对象层时是空类型
+    [[no_unique_address]] std::conditional_t<SPANS || MEDIUM, cursor_state, detail::no_stats> span_cursors;
+
+    /**
+     * @brief 大小类是否属于中等对象层
+     */
+    static constexpr bool is_medium_class(std::size_t index) noexcept {
+        return MEDIUM && index % table::count >= table::small_count;
+    }
+
+    /**
+     * @brief 中等对象 span 的字节数：按页取整，至少 MEDIUM_SPAN_BYTES 和 MEDIUM_SPAN_OBJECTS 个对象
+     */
+    static constexpr std::size_t medium_span_bytes(std::size_t size) noexcept {
+        std::size_t bytes = std::max(MEDIUM_SPAN_BYTES, size * MEDIUM_SPAN_OBJECTS);
+        return (bytes + detail::PAGE_SIZE - 1) & ~(detail::PAGE_SIZE - 1);
+    }
+
+    /**
+     * @brief 从索引为 index 的中等大小类当前的 span 切分 nobjs 个对象
+     *
+     * span 按页对齐地从内存池（chunk_alloc）中切出，当前 span 不足一个对象时把零头挂入小对象空闲链表再切新 span。
+     * 按大小类划分内存块时由 span_alloc 处理，不经过这里。
+     */
+    char* medium_alloc(std::size_t index, int& nobjs) requires (MEDIUM && !SPANS);
+
+    /**
+     * @brief 从索引为 index 的大小类专属的内存块切分 nobjs 个对象，当前块不足一个对象时申请新块
+     *
+     * 新块按页对齐，其覆盖的页登记为该大小类；当前块剩余的零头不足一个对象，留在块中不再使用。
+     */
+    char* span_alloc(std::size_t index, int& nobjs) requires (SPANS);
+
+    /**
+     * @brief 大对象计入统计的字节数，按大小类划分时按页取整
+     */
+    static constexpr std::size_t large_bytes(std::size_t bytes) noexcept {
+        if constexpr (SPANS) {
+            return (bytes + detail::PAGE_SIZE - 1) & ~(detail::PAGE_SIZE - 1);
+        } else {
+            return bytes;
+        }
+    }
+
+    /**
+     * @brief 向上游申请大对象；按大小类划分时按页取整，并在首页登记页数和对齐
+     */
+    void* allocate_large(std::size_t bytes, std::size_t alignment);
+
+    /**
+     * @brief 把大对象归还上游，大小和对齐与 allocate_large 相同
+     */
+    void deallocate_large(void* p, std::size_t bytes, std::size_t alignment) noexcept;
+
+    /**
+     * @brief 记录索引为 index 的大小类分配了 n 个对象，并更新峰值
+     */
+    void count_allocations(std::size_t index, std::size_t n) noexcept {
+        if constexpr (Options.enable_stats) {
+            class_counters& c = counters.classes[index];
+            c.allocations.add(n);
+            std::uint64_t live = c.allocations.load() - c.deallocations.load();
+            if (live > c.high_water.load()) {
+                c.high_water.set(live);
+            }
+        }
+    }
+
+    /**
+     * @brief 记录索引为 index 的大小类释放了 n 个对象
+     */
+    void count_deallocations(std::size_t index, std::size_t n) noexcept {
+        if constexpr (Options.enable_stats) {
+            counters.classes[index].deallocations.add(n);
+        }
+    }
+
+    /**
+     * @brief 向上取整到最近的 ALIGN 倍数
+     */
+    static std::size_t round_up(std::size_t bytes) {
+        return ((bytes + ALIGN - 1) & ~(ALIGN - 1));
+    }
+
+    /**
+     * @brief 获取给定大小和对齐的空闲链表索引（编译期查找表）
+     *
+     * 对齐超过 ALIGN 时，先把大小取整到该对齐，再在对应对齐层中查找。
+     */
+    static constexpr std::size_t free_list_index(std::size_t bytes, std::size_t alignment = ALIGN) {
+        if (alignment <= ALIGN) {
+            return table::index[(bytes + ALIGN - 1) / ALIGN];
+        }
+        std::size_t tier = std::countr_zero(alignment) - std::countr_zero(ALIGN);
+        std::size_t rounded = (bytes + alignment - 1) & ~(alignment - 1);
+        return tier * table::count + table::index[rounded / ALIGN];
+    }
+
+    /**
+     * @brief 获取空闲链表中对象的对齐
+     */
+    static constexpr std::size_t free_list_alignment(std::size_t index) {
+        return ALIGN << (index / table::count);
+    }
+
+    /**
+     * @brief 把零头挂入不超过其大小的最大基础对齐大小类
+     */
+    void add_leftover(char* p, std::size_t bytes);
+
+    /**
+     * @brief 从内存池切分 nobjs 个 size 大小、按 align 对齐的对象
+     *
+     * 内存池不足时向系统申请新块，申请量随 heap_size 几何增长；
+     * 内存池的剩余零头以及对齐产生的空隙挂入对应的较小空闲链表。
+     * 内存池不足以切出 nobjs 个对象时会减少 nobjs。
+     */
+    char* chunk_alloc(std::size_t size, int& nobjs, std::size_t align = ALIGN);
+
+    /**
+     * @brief 重新填充索引为 index 的空闲链表
+     */
+    void* refill(std::size_t index);
+
+    /**
+     * @brief 统计每个内存块的空闲字节数，把完全空闲的块从空闲链表中摘除并归还上游
+     *
+     * 按地址排序内存块后，扫描所有空闲链表和内存池剩余区间，
+     * 按对象所在的块累加空闲字节，空闲字节等于块大小的块即完全空闲。
+     * 从最新（最大）的块开始归还，持有字节数不超过 target_bytes 时停止。
+     * min_idle 非零时只归还连续空闲超过 min_idle 的块。
+     *
+     * @return 归还上游的字节数
+     */
+    std::size_t release_free_chunks(std::size_t target_bytes, std::chrono::milliseconds min_idle);
+
+    /**
+     * @brief 为新内存块预留 memory_chunks 和 chunk_free_bytes 的位置，在向上游申请之前调用，
+     * 避免申请成功后记录失败导致泄漏
+     */
+    void reserve_chunk_record();
+
+    /**
+     * @brief 启用衰减时由释放路径调用，按间隔触发 decay()
+     *
+     * 每 DECAY_CHECK_INTERVAL 次释放读一次时钟，距上次扫描不足 decay_ms / 2 时直接返回；
+     * 否则在释放路径上（同步资源持锁）做一次 O(内存块数 + 空闲对象数) 的扫描，不分配内存。
+     */
+    void decay_tick() noexcept;
+
+public:
+    basic_sgi_pool_resource_base();
+    explicit basic_sgi_pool_resource_base(std::pmr::memory_resource* upstream);
+    virtual ~basic_sgi_pool_resource_base();
+
+    basic_sgi_pool_resource_base(const basic_sgi_pool_resource_base&) = delete;
+    basic_sgi_pool_resource_base& operator=(const basic_sgi_pool_resource_base&) = delete;
+
+    /**
+     * @brief 分配实现
+     */
+    void* allocate_impl(std::size_t bytes, std::size_t alignment);
+
+    /**
+     * @brief 释放实现
+     */
+    void deallocate_impl(void* p, std::size_t bytes, std::size_t alignment);
+
+    /**
+     * @brief 不带大小的释放，仅在 Options.size_class_spans 为 true 时可用
+     *
+     * 通过页映射查出对象所属的大小类或大对象的页数。p 不属于本资源时不做任何事并返回 false，
+     * 调用方可以据此把指针交给其他分配器（例如 C 的 free）。
+     */
+    bool deallocate_unsized(void* p) requires (SPANS);
+
+    /**
+     * @brief 对象是否由本资源分配，仅在 Options.size_class_spans 为 true 时可用
+     *
+     * 池化对象按所在页判断；大对象只登记首页，需要传入分配返回的指针。
+     */
+    bool owns(const void* p) const noexcept requires (SPANS) {
+        page_info info = spans.pages.get(p);
+        return info.index != 0 || info.large_pages != 0;
+    }
+
+    /**
+     * @brief 对象的可用字节数（所属大小类的大小或大对象占用的页），不属于本资源时返回 0
+     */
+    std::size_t allocation_size(const void* p) const noexcept requires (SPANS) {
+        page_info info = spans.pages.get(p);
+        if (info.index != 0) {
+            return table::tier_sizes[info.index - 1];
+        }
+        return std::size_t{info.large_pages} << detail::PAGE_SHIFT;
+    }
+
+    /**
+     * @brief 从索引为 index 的大小类取一个对象，空闲链表为空时 refill
+     *
+     * 供编译期已知大小类的调用方（例如 object_pool）使用，省去大小判断和查表。
+     * 采样按大小类的字节数计，与链式接口一致。
+     */
+    void* allocate_class(std::size_t index) {
+        count_allocations(index, 1);
+
+        obj* result = free_lists[index];
+        if (result) {
+            // 从空闲链表中移除
+            free_lists[index] = result->free_list_link;
+        } else {
+            // 空闲链表为空，重新填充
+            result = static_cast<obj*>(refill(index));
+        }
+
+        if constexpr (SAMPLING) {
+            advance_sampler(result, table::tier_sizes[index]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief 把对象挂回索引为 index 的空闲链表
+     */
+    void deallocate_class(std::size_t index, void* p) noexcept {
+        count_deallocations(index, 1);
+
+        if constexpr (SAMPLING) {
+            profiler::global().record_deallocation(p);
+        }
+
+        obj* q = static_cast<obj*>(p);
+        q->free_list_link = free_lists[index];
+        free_lists[index] = q;
+
+        if constexpr (Options.decay_ms > 0) {
+            decay_tick();
+        }
+    }
+
+    /**
+     * @brief 判断给定大小和对齐的请求是否由空闲链表处理
+     */
+    static constexpr bool is_pooled(std::size_t bytes, std::size_t alignment) noexcept {
+        if (alignment <= ALIGN) {
+            return bytes <= MAX_BYTES;
+        }
+        return alignment <= MAX_ALIGN && ((bytes + alignment - 1) & ~(alignment - 1)) <= MAX_BYTES;
+    }
+
+    /**
+     * @brief 大小类的数量
+     */
+    static constexpr std::size_t size_class_count() noexcept {
+        return NFREELISTS;
+    }
+
+    /**
+     * @brief 向上游申请内存块的对齐；簿记数据（例如记录内存块的数组）的请求按其类型对齐，不会超过
+     * alignof(std::max_align_t)
+     */
+    static constexpr std::size_t chunk_alignment() noexcept {
+        return CHUNK_ALIGN;
+    }
+
+    /**
+     * @brief 获取给定大小和对齐所属大小类的索引
+     */
+    static constexpr std::size_t size_class_index(std::size_t bytes, std::size_t alignment = ALIGN) noexcept {
+        return free_list_index(bytes, alignment);
+    }
+
+    /**
+     * @brief 获取大小类索引对应的对象大小
+     */
+    static constexpr std::size_t size_class_bytes(std::size_t index) noexcept {
+        return table::tier_sizes[index];
+    }
+
+    /**
+     * @brief 获取大小类索引对应的对象对齐
+     */
+    static constexpr std::size_t size_class_alignment(std::size_t index) noexcept {
+        return free_list_alignment(index);
+    }
+
+    /**
+     * @brief 上游内存资源
+     */
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return upstream_;
+    }
+
+    /**
+     * @brief 已向上游申请的内存块数量
+     */
+    std::size_t chunk_count() const noexcept {
+        return memory_chunks.size();
+    }
+
+    /**
+     * @brief 当前持有的内存块总字节数
+     */
+    std::size_t held_bytes() const noexcept {
+        return heap_size;
+    }
+
+    /**
+     * @brief 把所有完全空闲的内存块归还上游
+     *
+     * 与 std::pmr 池资源的 release() 不同，仍有对象在使用的内存块不受影响。
+     *
+     * @return 归还上游的字节数
+     */
+    std::size_t release() {
+        return trim(0);
+    }
+
+    /**
+     * @brief 归还完全空闲的内存块，直到持有的字节数不超过 target_bytes
+     *
+     * @return 归还上游的字节数
+     */
+    std::size_t trim(std::size_t target_bytes) {
+        return release_free_chunks(target_bytes, std::chrono::milliseconds(0));
+    }
+
+    /**
+     * @brief 归还连续空闲超过 Options.decay_ms 的内存块
+     *
+     * 每次调用记录当前完全空闲的块，之后的调用发现它们仍然空闲且超过阈值时归还。
+     * 启用衰减时释放路径会定期自动调用。
+     *
+     * @return 归还上游的字节数
+     */
+    std::size_t decay() {
+        return release_free_chunks(0, std::chrono::milliseconds(Options.decay_ms));
+    }
 
     /**
-     * @brief 向上取整到最近的 ALIGN 倍数
+     * @brief 索引为 index 的大小类当前的 refill 批量，固定批量时总是 Options.refill_batch
      */
-    static std::size_t round_up(std::size_t bytes) {
-        return ((bytes + ALIGN - 1) & ~(ALIGN - 1));
+    std::size_t refill_batch(std::size_t index) const noexcept {
+        if constexpr (ADAPTIVE_REFILL) {
+            return refill_batches.batches[index];
+        } else {
+            return Options.refill_batch;
+        }
     }
 
     /**
-     * @brief 获取给定大小的空闲链表索引
+     * @brief 统计快照，仅在 Options.enable_stats 为 true 时可用
+     *
+     * 计数器可以无锁读取，但空闲链表长度和空闲字节需要遍历空闲链表，
+     * 调用方需要与分配和释放互斥。
      */
-    static std::size_t free_list_index(std::size_t bytes) {
-        return ((bytes + ALIGN - 1) / ALIGN - 1);
-    }
+    pool_stats stats() const requires (Options.enable_stats);
 
     /**
-     * @brief 为空闲链表分配内存块
+     * @brief 批量分配：从索引为 index 的大小类取出 count 个对象
+     *
+     * 对象通过首个字长串成单向链表，head 为第一个对象，tail 为最后一个对象。
+     * 空闲链表不足时会调用 refill 补充。index 由 size_class_index 得到。
+     * refill 失败时已取出的对象放回空闲链表，异常继续抛出。
+     *
+     * @return 实际取得的对象数量（总是等于 count）
      */
-    char* chunk_alloc(std::size_t size, int& nobjs);
+    std::size_t allocate_chain(std::size_t index, std::size_t count, void*& head, void*& tail);
 
     /**
-     * @brief 重新填充空闲链表
+     * @brief 批量释放：把 head 到 tail 的整段链表一次性拼接回索引为 index 的空闲链表
      */
-    void* refill(std::size_t size);
+    void deallocate_chain(std::size_t index, void* head, void* tail) noexcept;
 
-public:
-    sgi_pool_resource_base();
-    virtual ~sgi_pool_resource_base();
+    /**
+     * @brief 批量分配 count 个大小和对齐相同的对象，写入 out[0..count)
+     *
+     * 池化大小从空闲链表上一次取下一整段，只在最后改写一次表头；
+     * 失败时已取得的对象全部归还，然后抛出异常。
+     */
+    void allocate_bulk(std::size_t bytes, std::size_t alignment, std::size_t count, void** out);
 
-    sgi_pool_resource_base(const sgi_pool_resource_base&) = delete;
-    sgi_pool_resource_base& operator=(const sgi_pool_resource_base&) = delete;
+    /**
+     * @brief 批量释放 ptrs[0..count) 中大小和对齐相同的对象，指针不能为空
+     *
+     * 池化大小先把对象串成一段，再整段拼接回空闲链表。
+     */
+    void deallocate_bulk(void* const* ptrs, std::size_t count, std::size_t bytes, std::size_t alignment);
+};
 
+/**
+ * @brief 支持批量分配和释放的内存资源接口
+ *
+ * 与 std::pmr::memory_resource 一样采用非虚接口：公开函数转发给受保护的虚函数。
+ * 默认实现逐个调用 allocate/deallocate，池资源覆盖它们以便整批只加一次锁。
+ */
+class bulk_memory_resource : public std::pmr::memory_resource {
+public:
     /**
-     * @brief 分配实现
+     * @brief 分配 count 个对象写入 out，要么全部成功，要么抛出异常且不分配任何对象
      */
-    void* allocate_impl(std::size_t bytes, std::size_t alignment);
+    void allocate_bulk(std::size_t bytes, std::size_t alignment, std::size_t count, void** out) {
+        do_allocate_bulk(bytes, alignment, count, out);
+    }
 
     /**
-     * @brief 释放实现
+     * @brief 释放 ptrs 中的 count 个对象，它们必须以相同的大小和对齐分配自本资源
      */
-    void deallocate_impl(void* p, std::size_t bytes, std::size_t alignment);
+    void deallocate_bulk(void* const* ptrs, std::size_t count, std::size_t bytes, std::size_t alignment) {
+        do_deallocate_bulk(ptrs, count, bytes, alignment);
+    }
+
+protected:
+    virtual void do_allocate_bulk(std::size_t bytes, std::size_t alignment, std::size_t count, void** out) {
+        std::size_t done = 0;
+        try {
+            for (; done < count; ++done) {
+                out[done] = allocate(bytes, alignment);
+            }
+        } catch (...) {
+            while (done > 0) {
+                --done;
+                deallocate(out[done], bytes, alignment);
+            }
+            throw;
+        }
+    }
+
+    virtual void do_deallocate_bulk(void* const* ptrs, std::size_t count, std::size_t bytes, std::size_t alignment) {
+        for (std::size_t i = 0; i < count; ++i) {
+            deallocate(ptrs[i], bytes, alignment);
+        }
+    }
 };
 
 /**
@@ -87,22 +895,86 @@ public:
  *
  * 此资源使用互斥锁确保线程安全。
  */
-class synchronized_pool_resource : public std::pmr::memory_resource {
+template <pool_options Options = pool_options{}>
+class basic_synchronized_pool_resource : public bulk_memory_resource {
 private:
-    sgi_pool_resource_base base_;
+    basic_sgi_pool_resource_base<Options> base_;
     std::mutex mutex_;
 
 public:
-    synchronized_pool_resource();
-    ~synchronized_pool_resource() override = default;
+    basic_synchronized_pool_resource();
+    explicit basic_synchronized_pool_resource(std::pmr::memory_resource* upstream);
+    ~basic_synchronized_pool_resource() override = default;
+
+    basic_synchronized_pool_resource(const basic_synchronized_pool_resource&) = delete;
+    basic_synchronized_pool_resource& operator=(const basic_synchronized_pool_resource&) = delete;
+
+    /**
+     * @brief 上游内存资源
+     */
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return base_.upstream_resource();
+    }
+
+    /**
+     * @brief 把所有完全空闲的内存块归还上游，返回归还的字节数
+     */
+    std::size_t release();
+
+    /**
+     * @brief 归还完全空闲的内存块，直到持有的字节数不超过 target_bytes
+     */
+    std::size_t trim(std::size_t target_bytes);
+
+    /**
+     * @brief 归还连续空闲超过 Options.decay_ms 的内存块
+     */
+    std::size_t decay();
+
+    /**
+     * @brief 统计快照，仅在 Options.enable_stats 为 true 时可用
+     */
+    pool_stats stats() requires (Options.enable_stats);
+
+    /**
+     * @brief 不带大小的释放，p 不属于本资源时返回 false，仅在 Options.size_class_spans 为 true 时可用
+     */
+    bool deallocate_unsized(void* p) requires (Options.size_class_spans);
+
+    /**
+     * @brief 对象是否由本资源分配，页映射的查找无锁
+     */
+    bool owns(const void* p) const noexcept requires (Options.size_class_spans) {
+        return base_.owns(p);
+    }
+
+    /**
+     * @brief 对象的可用字节数，不属于本资源时返回 0
+     */
+    std::size_t allocation_size(const void* p) const noexcept requires (Options.size_class_spans) {
+        return base_.allocation_size(p);
+    }
+
+    /**
+     * @brief 获取和释放资源的锁，用于 pthread_atfork：fork 前加锁，父子进程中各自解锁，
+     * 子进程不会继承一把由已不存在的线程持有的锁
+     */
+    void lock() {
+        mutex_.lock();
+    }
 
-    synchronized_pool_resource(const synchronized_pool_resource&) = delete;
-    synchronized_pool_resource& operator=(const synchronized_pool_resource&) = delete;
+    void unlock() {
+        mutex_.unlock();
+    }
 
 protected:
     void* do_allocate(std::size_t bytes, std::size_t alignment) override;
     void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
     bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    // 整批只加一次锁
+    void do_allocate_bulk(std::size_t bytes, std::size_t alignment, std::size_t count, void** out) override;
+    void do_deallocate_bulk(void* const* ptrs, std::size_t count, std::size_t bytes, std::size_t alignment) override;
 };
 
 /**
@@ -110,23 +982,100 @@ protected:
  *
  * 此资源不使用锁，适用于单线程使用。
  */
-class unsynchronized_pool_resource : public std::pmr::memory_resource {
+template <pool_options Options = pool_options{}>
+class basic_unsynchronized_pool_resource : public bulk_memory_resource {
 private:
-    sgi_pool_resource_base base_;
+    basic_sgi_pool_resource_base<Options> base_;
 
 public:
-    unsynchronized_pool_resource();
-    ~unsynchronized_pool_resource() override = default;
+    basic_unsynchronized_pool_resource();
+    explicit basic_unsynchronized_pool_resource(std::pmr::memory_resource* upstream);
+    ~basic_unsynchronized_pool_resource() override = default;
+
+    basic_unsynchronized_pool_resource(const basic_unsynchronized_pool_resource&) = delete;
+    basic_unsynchronized_pool_resource& operator=(const basic_unsynchronized_pool_resource&) = delete;
+
+    /**
+     * @brief 上游内存资源
+     */
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return base_.upstream_resource();
+    }
 
-    unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
-    unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+    /**
+     * @brief 把所有完全空闲的内存块归还上游，返回归还的字节数
+     */
+    std::size_t release() {
+        return base_.release();
+    }
+
+    /**
+     * @brief 归还完全空闲的内存块，直到持有的字节数不超过 target_bytes
+     */
+    std::size_t trim(std::size_t target_bytes) {
+        return base_.trim(target_bytes);
+    }
+
+    /**
+     * @brief 归还连续空闲超过 Options.decay_ms 的内存块
+     */
+    std::size_t decay() {
+        return base_.decay();
+    }
+
+    /**
+     * @brief 统计快照，仅在 Options.enable_stats 为 true 时可用
+     */
+    pool_stats stats() const requires (Options.enable_stats) {
+        return base_.stats();
+    }
+
+    /**
+     * @brief 不带大小的释放，p 不属于本资源时返回 false，仅在 Options.size_class_spans 为 true 时可用
+     */
+    bool deallocate_unsized(void* p) requires (Options.size_class_spans) {
+        return base_.deallocate_unsized(p);
+    }
+
+    /**
+     * @brief 对象是否由本资源分配
+     */
+    bool owns(const void* p) const noexcept requires (Options.size_class_spans) {
+        return base_.owns(p);
+    }
+
+    /**
+     * @brief 对象的可用字节数，不属于本资源时返回 0
+     */
+    std::size_t allocation_size(const void* p) const noexcept requires (Options.size_class_spans) {
+        return base_.allocation_size(p);
+    }
 
 protected:
     void* do_allocate(std::size_t bytes, std::size_t alignment) override;
     void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
     bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    void do_allocate_bulk(std::size_t bytes, std::size_t alignment, std::size_t count, void** out) override {
+        base_.allocate_bulk(bytes, alignment, count, out);
+    }
+
+    void do_deallocate_bulk(void* const* ptrs, std::size_t count, std::size_t bytes, std::size_t alignment) override {
+        base_.deallocate_bulk(ptrs, count, bytes, alignment);
+    }
 };
 
+// 默认配置下的类型，与 std::pmr 中的同名资源对应
+using sgi_pool_resource_base = basic_sgi_pool_resource_base<>;
+using synchronized_pool_resource = basic_synchronized_pool_resource<>;
+using unsynchronized_pool_resource = basic_unsynchronized_pool_resource<>;
+
+// 启用中等对象层的配置：max_bytes 到 32KB 之间的请求也由空闲链表处理。
+// 内存块改为按页对齐，中等对象 span 至少 64KB，只分配小对象的负载会多占内存，因此不是默认配置
+inline constexpr pool_options medium_pool_options{.medium_max_bytes = 32768};
+using medium_synchronized_pool_resource = basic_synchronized_pool_resource<medium_pool_options>;
+using medium_unsynchronized_pool_resource = basic_unsynchronized_pool_resource<medium_pool_options>;
+
 /**
  * @brief 使用SGI内存资源的多态分配器
  */
@@ -140,9 +1089,9 @@ public:
 
     polymorphic_allocator() noexcept : mr_(std::pmr::get_default_resource()) {}
     explicit polymorphic_allocator(std::pmr::memory_resource* mr) noexcept : mr_(mr) {}
-    
+
     template <typename U>
-    polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept 
+    polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept
         : mr_(other.resource()) {}
 
     T* allocate(std::size_t n) {
@@ -153,6 +1102,44 @@ public:
         mr_->deallocate(p, n * sizeof(T), alignof(T));
     }
 
+    /**
+     * @brief 分配 count 个单独的 T 对象（不构造），资源支持批量接口时整批分配
+     */
+    void allocate_bulk(std::size_t count, T** out) {
+        // T* 与 void* 的表示相同，直接把输出数组当作 void* 数组填写
+        void** slots = reinterpret_cast<void**>(out);
+        if (auto* bulk = dynamic_cast<bulk_memory_resource*>(mr_)) {
+            bulk->allocate_bulk(sizeof(T), alignof(T), count, slots);
+            return;
+        }
+
+        std::size_t done = 0;
+        try {
+            for (; done < count; ++done) {
+                out[done] = allocate(1);
+            }
+        } catch (...) {
+            while (done > 0) {
+                --done;
+                deallocate(out[done], 1);
+            }
+            throw;
+        }
+    }
+
+    /**
+     * @brief 释放由 allocate_bulk 分配（或逐个 allocate(1) 分配）的 count 个对象
+     */
+    void deallocate_bulk(T* const* ptrs, std::size_t count) {
+        if (auto* bulk = dynamic_cast<bulk_memory_resource*>(mr_)) {
+            bulk->deallocate_bulk(reinterpret_cast<void* const*>(ptrs), count, sizeof(T), alignof(T));
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            deallocate(ptrs[i], 1);
+        }
+    }
+
     std::pmr::memory_resource* resource() const noexcept { return mr_; }
 
     template <typename U>
@@ -166,4 +1153,805 @@ public:
     }
 };
 
-} // namespace sgi_pmr
\ No newline at end of file
+// basic_sgi_pool_resource_base 实现
+template <pool_options Options>
+basic_sgi_pool_resource_base<Options>::basic_sgi_pool_resource_base()
+    : basic_sgi_pool_resource_base(std::pmr::get_default_resource()) {}
+
+template <pool_options Options>
+basic_sgi_pool_resource_base<Options>::basic_sgi_pool_resource_base(std::pmr::memory_resource* upstream)
+    : upstream_(upstream), memory_chunks(upstream), chunk_free_bytes(upstream), start_free(nullptr), end_free(nullptr), heap_size(0),
+      spans(upstream) {
+    // 初始化所有空闲链表为 nullptr
+    for (std::size_t i = 0; i < NFREELISTS; ++i) {
+        free_lists[i] = nullptr;
+    }
+    if constexpr (ADAPTIVE_REFILL) {
+        for (std::size_t i = 0; i < NFREELISTS; ++i) {
+            refill_batches.batches[i] = Options.refill_batch;
+            refill_batches.last_refill[i] = 0;
+        }
+    }
+    if constexpr (SAMPLING) {
+        sampler.rng = (reinterpret_cast<std::uintptr_t>(this) * 0x9E3779B97F4A7C15ull) | 1;
+        sampler.bytes_until_sample = static_cast<std::ptrdiff_t>(
+            profiler::next_sample_interval(sampler.rng, Options.sample_interval_bytes));
+    }
+    if constexpr (SPANS || MEDIUM) {
+        for (std::size_t i = 0; i < NFREELISTS; ++i) {
+            span_cursors.cursors[i] = span_cursors.ends[i] = nullptr;
+        }
+    }
+}
+
+template <pool_options Options>
+basic_sgi_pool_resource_base<Options>::~basic_sgi_pool_resource_base() {
+    // 把所有内存块归还上游
+    for (const chunk& c : memory_chunks) {
+        upstream_->deallocate(c.data, c.bytes, CHUNK_ALIGN);
+    }
+    memory_chunks.clear();
+}
+
+template <pool_options Options>
+void* basic_sgi_pool_resource_base<Options>::allocate_impl(std::size_t bytes, std::size_t alignment) {
+    void* p;
+    if (!is_pooled(bytes, alignment)) {
+        // 对于大分配，直接交给上游
+        p = allocate_large(bytes, alignment);
+        if constexpr (Options.enable_stats) {
+            counters.large_allocations.add();
+            counters.large_bytes.add(large_bytes(bytes));
+        }
+        if constexpr (SAMPLING) {
+            advance_sampler(p, bytes);
+        }
+        return p;
+    }
+
+    // 通过查找表确定大小类；采样在 allocate_class 中进行
+    return allocate_class(free_list_index(bytes, alignment));
+}
+
+template <pool_options Options>
+void basic_sgi_pool_resource_base<Options>::sample_allocation(void* p, std::size_t bytes) requires (SAMPLING) {
+    sampler.bytes_until_sample = static_cast<std::ptrdiff_t>(
+        profiler::next_sample_interval(sampler.rng, Options.sample_interval_bytes));
+
+    // 记录失败只丢失这一次采样，不影响分配本身
+    try {
+        profiler::global().record_allocation(p, bytes, Options.sample_interval_bytes);
+    } catch (const std::bad_alloc&) {
+    }
+}
+
+template <pool_options Options>
+void basic_sgi_pool_resource_base<Options>::deallocate_impl(void* p, std::size_t bytes, std::size_t alignment) {
+    if (!p) return;
+
+    // 对于大分配，直接归还上游
+    if (!is_pooled(bytes, alignment)) {
+        if constexpr (SAMPLING) {
+            profiler::global().record_deallocation(p);
+        }
+        deallocate_large(p, bytes, alignment);
+        if constexpr (Options.enable_stats) {
+            counters.large_deallocations.add();
+            counters.large_bytes.sub(large_bytes(bytes));
+        }
+        return;
+    }
+
+    deallocate_class(free_list_index(bytes, alignment), p);
+}
+
+template <pool_options Options>
+bool basic_sgi_pool_resource_base<Options>::deallocate_unsized(void* p) requires (SPANS) {
+    if (!p) return true;
+
+    page_info info = spans.pages.get(p);
+    if (info.index == 0 && info.large_pages == 0) {
+        return false;
+    }
+
+    if (info.index != 0) {
+        deallocate_class(info.index - 1, p);
+        return true;
+    }
+
+    // 大对象：按登记的页数和对齐归还
+    if constexpr (SAMPLING) {
+        profiler::global().record_deallocation(p);
+    }
+    std::size_t bytes = std::size_t{info.large_pages} << detail::PAGE_SHIFT;
+    deallocate_large(p, bytes, std::size_t{1} << info.align_log2);
+    if constexpr (Options.enable_stats) {
+        counters.large_deallocations.add();
+        counters.large_bytes.sub(bytes);
+    }
+    return true;
+}
+
+template <pool_options Options>
+void* basic_sgi_pool_resource_base<Options>::allocate_large(std::size_t bytes, std::size_t alignment) {
+    if constexpr (SPANS) {
+        std::size_t size = large_bytes(bytes);
+        std::size_t align = std::max(alignment, detail::PAGE_SIZE);
+        void* p = upstream_->allocate(size, align);
+        try {
+            page_info info{static_cast<std::uint32_t>(size >> detail::PAGE_SHIFT), 0,
+                           static_cast<std::uint8_t>(std::countr_zero(align)), 0};
+            spans.pages.set_range(p, 1, info);
+        } catch (...) {
+            upstream_->deallocate(p, size, align);
+            throw;
+        }
+        return p;
+    } else {
+        return upstream_->allocate(bytes, alignment);
+    }
+}
+
+template <pool_options Options>
+void basic_sgi_pool_resource_base<Options>::deallocate_large(void* p, std::size_t bytes,
+                                                             std::size_t alignment) noexcept {
+    if constexpr (SPANS) {
+        spans.pages.clear_range(p, 1);
+        upstream_->deallocate(p, large_bytes(bytes), std::max(alignment, detail::PAGE_SIZE));
+    } else {
+        upstream_->deallocate(p, bytes, alignment);
+    }
+}
+
+template <pool_options Options>
+std::size_t basic_sgi_pool_resource_base<Options>::allocate_chain(std::size_t index, std::size_t count,
+                                                                 void*& head, void*& tail) {
+    head = tail = nullptr;
+    if (count == 0) return 0;
+
+    obj* first = nullptr;
+    obj* last = nullptr;
+    std::size_t taken = 0;
+
+    try {
+        while (taken < count) {
+            obj* current = free_lists[index];
+            if (!current) {
+                // 空闲链表为空，refill 返回一个对象并把其余对象挂到空闲链表上
+                current = static_cast<obj*>(refill(index));
+            } else {
+                free_lists[index] = current->free_list_link;
+            }
+
+            if (last) {
+                last->free_list_link = current;
+            } else {
+                first = current;
+            }
+            last = current;
+            ++taken;
+        }
+    } catch (...) {
+        // refill 失败，把已取出的一段整体拼回空闲链表
+        if (last) {
+            last->free_list_link = free_lists[index];
+            free_lists[index] = first;
+        }
+        throw;
+    }
+
+    last->free_list_link = nullptr;
+    head = first;
+    tail = last;
+    count_allocations(index, taken);
+
+    if constexpr (SAMPLING) {
+        for (obj* p = first; p; p = p->free_list_link) {
+            advance_sampler(p, table::tier_sizes[index]);
+        }
+    }
+    return taken;
+}
+
+template <pool_options Options>
+void basic_sgi_pool_resource_base<Options>::deallocate_chain(std::size_t index, void* head, void* tail) noexcept {
+    if (!head) return;
+
+    if constexpr (Options.enable_stats) {
+        std::size_t n = 1;
+        for (obj* p = static_cast<obj*>(head); p != tail; p = p->free_list_link) {
+            ++n;
+        }
+        count_deallocations(index, n);
+    }
+    if constexpr (SAMPLING) {
+        for (obj* p = static_cast<obj*>(head);; p = p->free_list_link) {
+            profiler::global().record_deallocation(p);
+            if (p == tail) break;
+        }
+    }
+
+    // 整段拼接，O(1)
+    static_cast<obj*>(tail)->free_list_link = free_lists[index];
+    free_lists[index] = static_cast<obj*>(head);
+
+    if constexpr (Options.decay_ms > 0) {
+        decay_tick();
+    }
+}
+
+template <pool_options Options>
+void basic_sgi_pool_resource_base<Options>::allocate_bulk(std::size_t bytes, std::size_t alignment,
+                                                          std::size_t count, void** out) {
+    if (count == 0) return;
+
+    if (!is_pooled(bytes, alignment)) {
+        std::size_t done = 0;
+        try {
+            for (; done < count; ++done) {
+                out[done] = allocate_impl(bytes, alignment);
+            }
+        } catch (...) {
+            while (done > 0) {
+                --done;
+                deallocate_impl(out[done], bytes, alignment);
+            }
+            throw;
+        }
+        return;
+    }
+
+    std::size_t index = free_list_index(bytes, alignment);
+    std::size_t done = 0;
+    try {
+        while (done < count) {
+            obj* current = free_lists[index];
+            if (!current) {
+                // refill 返回一个对象，其余对象挂到空闲链表上供下一轮取用
+                out[done++] = refill(index);
+                continue;
+            }
+
+            // 沿空闲链表取下一整段，最后只改写一次表头
+            while (current && done < count) {
+                out[done++] = current;
+                current = current->free_list_link;
+            }
+            free_lists[index] = current;
+        }
+    } catch (...) {
+        // refill 失败，把已取出的对象放回空闲链表
+        for (std::size_t i = 0; i < done; ++i) {
+            obj* q = static_cast<obj*>(out[i]);
+            q->free_list_link = free_lists[index];
+            free_lists[index] = q;
+        }
+        throw;
+    }
+    count_allocations(index, count);
+
+    if constexpr (SAMPLING) {
+        for (std::size_t i = 0; i < count; ++i) {
+            advance_sampler(out[i], bytes);
+        }
+    }
+}
+
+template <pool_options Options>
+void basic_sgi_pool_resource_base<Options>::deallocate_bulk(void* const* ptrs, std::size_t count,
+                                                            std::size_t bytes, std::size_t alignment) {
+    if (count == 0) return;
+
+    if (!is_pooled(bytes, alignment)) {
+        for (std::size_t i = 0; i < count; ++i) {
+            deallocate_impl(ptrs[i], bytes, alignment);
+        }
+        return;
+    }
+
+    if constexpr (SAMPLING) {
+        for (std::size_t i = 0; i < count; ++i) {
+            profiler::global().record_deallocation(ptrs[i]);
+        }
+    }
+
+    // 先串成一段，再整段拼接
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+        static_cast<obj*>(ptrs[i])->free_list_link = static_cast<obj*>(ptrs[i + 1]);
+    }
+    std::size_t index = free_list_index(bytes, alignment);
+    static_cast<obj*>(ptrs[count - 1])->free_list_link = free_lists[index];
+    free_lists[index] = static_cast<obj*>(ptrs[0]);
+    count_deallocations(index, count);
+
+    if constexpr (Options.decay_ms > 0) {
+        decay_tick();
+    }
+}
+
+template <pool_options Options>
+void basic_sgi_pool_resource_base<Options>::add_leftover(char* p, std::size_t bytes) {
+    // 零头可能大于 MAX_BYTES 或落在两个大小类之间，拆成若干对象，
+    // 使内存块的每个字节都可以在空闲链表中找到，trim 才能判断块是否完全空闲
+    while (bytes >= ALIGN) {
+        std::size_t index = bytes >= MAX_BYTES ? table::count - 1 : free_list_index(bytes);
+        if (table::sizes[index] > bytes) {
+            --index;
+        }
+        obj* leftover = reinterpret_cast<obj*>(p);
+        leftover->free_list_link = free_lists[index];
+        free_lists[index] = leftover;
+        p += table::sizes[index];
+        bytes -= table::sizes[index];
+    }
+}
+
+template <pool_options Options>
+char* basic_sgi_pool_resource_base<Options>::chunk_alloc(std::size_t size, int& nobjs, std::size_t align) {
+    char* result;
+    std::size_t total_bytes = size * nobjs;
+
+    // 超过 ALIGN 的对齐需要跳过一段空隙
+    char* aligned_start = reinterpret_cast<char*>(
+        (reinterpret_cast<std::uintptr_t>(start_free) + align - 1) & ~(align - 1));
+    std::size_t bytes_left = aligned_start <= end_free ? end_free - aligned_start : 0;
+
+    if (bytes_left >= size) {
+        if (bytes_left < total_bytes) {
+            // 内存池至少能提供一个对象
+            nobjs = static_cast<int>(bytes_left / size);
+            total_bytes = size * nobjs;
+        }
+        add_leftover(start_free, aligned_start - start_free);
+        result = aligned_start;
+        start_free = aligned_start + total_bytes;
+        return result;
+    }
+
+    // 内存池连一个对象都无法提供，把零头挂入对应的空闲链表
+    add_leftover(start_free, end_free - start_free);
+
+    // 申请量为需求的两倍再加上随已申请总量增长的附加量，
+    // 按 CHUNK_ALIGN 对齐申请，使各对齐层都能从块首开始切分
+    std::size_t bytes_to_get = (2 * total_bytes + (heap_size >> 4) + CHUNK_ALIGN - 1) & ~(CHUNK_ALIGN - 1);
+
+    reserve_chunk_record();
+    try {
+        start_free = static_cast<char*>(upstream_->allocate(bytes_to_get, CHUNK_ALIGN));
+    } catch (const std::bad_alloc&) {
+        start_free = nullptr;
+    }
+
+    if (!start_free) {
+        // 上游分配失败，尝试从同一对齐层更大的空闲链表中借一个对象作为内存池；
+        // 中等对象的 span 按页对齐，没有可借的大小类
+        std::size_t index = is_pooled(size, align) ? free_list_index(size, align) : NFREELISTS;
+        std::size_t tier_end = index < NFREELISTS ? (index / table::count + 1) * table::count : NFREELISTS;
+        for (; index < tier_end; ++index) {
+            obj* p = free_lists[index];
+            if (p) {
+                free_lists[index] = p->free_list_link;
+                start_free = reinterpret_cast<char*>(p);
+                end_free = start_free + table::tier_sizes[index];
+                return chunk_alloc(size, nobjs, align);
+            }
+        }
+        end_free = nullptr;
+        throw std::bad_alloc();
+    }
+
+    // 存储块以供后续释放
+    memory_chunks.push_back({start_free, bytes_to_get});
+    heap_size += bytes_to_get;
+    end_free = start_free + bytes_to_get;
+    return chunk_alloc(size, nobjs, align);
+}
+
+template <pool_options Options>
+char* basic_sgi_pool_resource_base<Options>::span_alloc(std::size_t index, int& nobjs) requires (SPANS) {
+    std::size_t size = table::tier_sizes[index];
+    char*& cursor = span_cursors.cursors[index];
+    char*& end = span_cursors.ends[index];
+
+    if (static_cast<std::size_t>(end - cursor) < size) {
+        // 与 chunk_alloc 相同的几何增长，按页取整
+        std::size_t bytes_to_get = (2 * size * nobjs + (heap_size >> 4) + detail::PAGE_SIZE - 1)
+                                   & ~(detail::PAGE_SIZE - 1);
+
+        reserve_chunk_record();
+        char* p = static_cast<char*>(upstream_->allocate(bytes_to_get, CHUNK_ALIGN));
+        try {
+            spans.pages.set_range(p, bytes_to_get, page_info{0, static_cast<std::uint16_t>(index + 1), 0, 0});
+        } catch (...) {
+            upstream_->deallocate(p, bytes_to_get, CHUNK_ALIGN);
+            throw;
+        }
+
+        memory_chunks.push_back({p, bytes_to_get});
+        heap_size += bytes_to_get;
+        cursor = p;
+        end = p + bytes_to_get;
+    }
+
+    std::size_t available = static_cast<std::size_t>(end - cursor) / size;
+    if (available < static_cast<std::size_t>(nobjs)) {
+        nobjs = static_cast<int>(available);
+    }
+    char* result = cursor;
+    cursor += size * nobjs;
+    return result;
+}
+
+template <pool_options Options>
+char* basic_sgi_pool_resource_base<Options>::medium_alloc(std::size_t index, int& nobjs)
+    requires (MEDIUM && !SPANS) {
+    std::size_t size = table::tier_sizes[index];
+    char*& cursor = span_cursors.cursors[index];
+    char*& end = span_cursors.ends[index];
+
+    if (static_cast<std::size_t>(end - cursor) < size) {
+        std::size_t span_bytes = medium_span_bytes(size);
+        int one = 1;
+        char* span = chunk_alloc(span_bytes, one, detail::PAGE_SIZE);
+
+        // 旧 span 的零头不足一个对象，挂入较小的空闲链表，使 trim 能判断块是否完全空闲
+        add_leftover(cursor, static_cast<std::size_t>(end - cursor));
+        cursor = span;
+        end = span + span_bytes;
+    }
+
+    std::size_t available = static_cast<std::size_t>(end - cursor) / size;
+    if (available < static_cast<std::size_t>(nobjs)) {
+        nobjs = static_cast<int>(available);
+    }
+    char* result = cursor;
+    cursor += size * nobjs;
+    return result;
+}
+
+template <pool_options Options>
+std::size_t basic_sgi_pool_resource_base<Options>::next_refill_batch(std::size_t index) noexcept {
+    if constexpr (ADAPTIVE_REFILL) {
+        refill_state& s = refill_batches;
+        std::size_t& batch = s.batches[index];
+        std::size_t now = ++s.refill_count;
+        std::size_t last = s.last_refill[index];
+        s.last_refill[index] = now;
+
+        if (last != 0) {
+            std::size_t distance = now - last;
+            if (distance <= REFILL_WINDOW) {
+                // 热点大小类：几何增长，减少 refill 次数
+                batch = std::min(batch * 2, Options.max_refill_batch);
+            } else if (distance > 2 * REFILL_WINDOW) {
+                // 冷门大小类：上次切分的对象在空闲链表中停留了很久
+                std::size_t halvings = std::min<std::size_t>(distance / REFILL_WINDOW - 1, 31);
+                batch = std::max(batch >> halvings, Options.min_refill_batch);
+            }
+        }
+        return batch;
+    } else {
+        static_cast<void>(index);
+        return Options.refill_batch;
+    }
+}
+
+template <pool_options Options>
+void* basic_sgi_pool_resource_base<Options>::refill(std::size_t index) {
+    int nobjs = static_cast<int>(next_refill_batch(index)); // 要分配的对象数量
+    std::size_t size = table::tier_sizes[index];
+    if constexpr (Options.enable_stats) {
+        counters.classes[index].refills.add();
+    }
+
+    if (is_medium_class(index)) {
+        nobjs = std::min(nobjs, static_cast<int>(std::max<std::size_t>(1, MEDIUM_REFILL_BYTES / size)));
+    }
+
+    char* chunk;
+    if constexpr (SPANS) {
+        chunk = span_alloc(index, nobjs);
+    } else if constexpr (MEDIUM) {
+        chunk = is_medium_class(index) ? medium_alloc(index, nobjs)
+                                       : chunk_alloc(size, nobjs, free_list_alignment(index));
+    } else {
+        chunk = chunk_alloc(size, nobjs, free_list_alignment(index));
+    }
+    if (nobjs == 1) {
+        return chunk;
+    }
+
+    // 第一个对象将被返回
+    obj* result = reinterpret_cast<obj*>(chunk);
+
+    // 空闲链表应从第二个对象开始；中等对象的 span 按页对齐，对齐空隙的零头可能恰好挂入本大小类，
+    // 新对象接在原有链表之前
+    obj* rest = free_lists[index];
+    obj* current = reinterpret_cast<obj*>(chunk + size);
+    free_lists[index] = current;
+
+    // 链接第二个到最后一个对象
+    for (int i = 2; i < nobjs; ++i) {
+        obj* next = reinterpret_cast<obj*>(reinterpret_cast<char*>(current) + size);
+        current->free_list_link = next;
+        current = next;
+    }
+    current->free_list_link = rest;
+
+    return result;
+}
+
+template <pool_options Options>
+std::size_t basic_sgi_pool_resource_base<Options>::release_free_chunks(std::size_t target_bytes,
+                                                                      std::chrono::milliseconds min_idle) {
+    if (memory_chunks.empty() || heap_size <= target_bytes) return 0;
+
+    auto now = std::chrono::steady_clock::now();
+    last_decay = now;
+
+    std::sort(memory_chunks.begin(), memory_chunks.end(),
+              [](const chunk& a, const chunk& b) { return a.data < b.data; });
+
+    // 对象所在内存块的下标
+    auto chunk_of = [this](const void* p) {
+        auto it = std::upper_bound(memory_chunks.begin(), memory_chunks.end(), static_cast<const char*>(p),
+                                   [](const char* q, const chunk& c) { return q < c.data; });
+        return static_cast<std::size_t>(it - memory_chunks.begin()) - 1;
+    };
+
+    // 每个块的空闲字节数，块被选中归还后标记为 0；表已在添加内存块时预留
+    std::size_t* free_bytes = chunk_free_bytes.data();
+    std::fill_n(free_bytes, memory_chunks.size(), 0);
+    for (std::size_t i = 0; i < NFREELISTS; ++i) {
+        for (obj* p = free_lists[i]; p; p = p->free_list_link) {
+            free_bytes[chunk_of(p)] += table::tier_sizes[i];
+        }
+    }
+    if (start_free != end_free) {
+        free_bytes[chunk_of(start_free)] += end_free - start_free;
+    }
+    if constexpr (SPANS) {
+        // 各大小类尚未切分的区间，以及每个块末尾不足一个对象的零头
+        for (std::size_t i = 0; i < NFREELISTS; ++i) {
+            if (span_cursors.cursors[i] != span_cursors.ends[i]) {
+                std::size_t left = span_cursors.ends[i] - span_cursors.cursors[i];
+                free_bytes[chunk_of(span_cursors.cursors[i])] += left - left % table::tier_sizes[i];
+            }
+        }
+        for (std::size_t i = 0; i < memory_chunks.size(); ++i) {
+            const chunk& c = memory_chunks[i];
+            free_bytes[i] += c.bytes % table::tier_sizes[spans.pages.get(c.data).index - 1];
+        }
+    } else if constexpr (MEDIUM) {
+        // 中等对象 span 尚未切分的区间（包括末尾的零头）
+        for (std::size_t i = 0; i < NFREELISTS; ++i) {
+            if (span_cursors.cursors[i] != span_cursors.ends[i]) {
+                free_bytes[chunk_of(span_cursors.cursors[i])] += span_cursors.ends[i] - span_cursors.cursors[i];
+            }
+        }
+    }
+
+    // 块按地址排序，几何增长下地址较大的通常也较新较大，从后往前归还
+    std::size_t held = heap_size;
+    bool any = false;
+    for (std::size_t i = memory_chunks.size(); i-- > 0;) {
+        chunk& c = memory_chunks[i];
+        bool idle = free_bytes[i] == c.bytes;
+        free_bytes[i] = 0;
+        if (!idle) {
+            c.idle_since = {};
+            continue;
+        }
+        if (min_idle.count() > 0) {
+            if (c.idle_since == std::chrono::steady_clock::time_point{}) {
+                c.idle_since = now;
+                continue;
+            }
+            if (now - c.idle_since < min_idle) continue;
+        }
+        if (held <= target_bytes) continue;
+
+        free_bytes[i] = c.bytes;
+        held -= c.bytes;
+        any = true;
+    }
+    if (!any) return 0;
+
+    // 从空闲链表中摘除位于待归还块中的对象
+    for (std::size_t i = 0; i < NFREELISTS; ++i) {
+        obj** link = &free_lists[i];
+        while (*link) {
+            if (free_bytes[chunk_of(*link)]) {
+                *link = (*link)->free_list_link;
+            } else {
+                link = &(*link)->free_list_link;
+            }
+        }
+    }
+    if (start_free != end_free && free_bytes[chunk_of(start_free)]) {
+        start_free = end_free = nullptr;
+    }
+    if constexpr (SPANS || MEDIUM) {
+        for (std::size_t i = 0; i < NFREELISTS; ++i) {
+            if (span_cursors.cursors[i] != span_cursors.ends[i] && free_bytes[chunk_of(span_cursors.cursors[i])]) {
+                span_cursors.cursors[i] = span_cursors.ends[i] = nullptr;
+            }
+        }
+    }
+
+    std::size_t released = 0;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < memory_chunks.size(); ++i) {
+        const chunk& c = memory_chunks[i];
+        if (free_bytes[i]) {
+            if constexpr (SPANS) {
+                spans.pages.clear_range(c.data, c.bytes);
+            }
+            upstream_->deallocate(c.data, c.bytes, CHUNK_ALIGN);
+            released += c.bytes;
+        } else {
+            memory_chunks[kept++] = c;
+        }
+    }
+    memory_chunks.resize(kept);
+    heap_size -= released;
+    return released;
+}
+
+template <pool_options Options>
+pool_stats basic_sgi_pool_resource_base<Options>::stats() const requires (Options.enable_stats) {
+    pool_stats result;
+    result.size_classes.resize(NFREELISTS);
+    for (std::size_t i = 0; i < NFREELISTS; ++i) {
+        size_class_stats& s = result.size_classes[i];
+        const class_counters& c = counters.classes[i];
+        s.bytes = table::tier_sizes[i];
+        s.alignment = free_list_alignment(i);
+        s.allocations = c.allocations.load();
+        s.deallocations = c.deallocations.load();
+        s.refills = c.refills.load();
+        s.refill_batch = refill_batch(i);
+        s.high_water = c.high_water.load();
+        for (obj* p = free_lists[i]; p; p = p->free_list_link) {
+            ++s.free_list_length;
+        }
+        result.free_bytes += s.free_list_length * s.bytes;
+    }
+
+    result.large_allocations = counters.large_allocations.load();
+    result.large_deallocations = counters.large_deallocations.load();
+    result.large_bytes = counters.large_bytes.load();
+    result.chunk_count = memory_chunks.size();
+    result.held_bytes = heap_size;
+    result.free_bytes += end_free - start_free;
+    if constexpr (SPANS || MEDIUM) {
+        for (std::size_t i = 0; i < NFREELISTS; ++i) {
+            result.free_bytes += span_cursors.ends[i] - span_cursors.cursors[i];
+        }
+    }
+    return result;
+}
+
+template <pool_options Options>
+void basic_sgi_pool_resource_base<Options>::decay_tick() noexcept {
+    if (--decay_countdown != 0) return;
+    decay_countdown = DECAY_CHECK_INTERVAL;
+
+    // 扫描间隔为阈值的一半，块最迟在空闲 1.5 倍阈值后归还
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_decay >= std::chrono::milliseconds(Options.decay_ms) / 2) {
+        decay();
+    }
+}
+
+template <pool_options Options>
+void basic_sgi_pool_resource_base<Options>::reserve_chunk_record() {
+    memory_chunks.reserve(memory_chunks.size() + 1);
+    if (chunk_free_bytes.size() < memory_chunks.size() + 1) {
+        chunk_free_bytes.resize(memory_chunks.capacity());
+    }
+}
+
+// basic_synchronized_pool_resource 实现
+template <pool_options Options>
+basic_synchronized_pool_resource<Options>::basic_synchronized_pool_resource() = default;
+
+template <pool_options Options>
+basic_synchronized_pool_resource<Options>::basic_synchronized_pool_resource(std::pmr::memory_resource* upstream)
+    : base_(upstream) {}
+
+template <pool_options Options>
+void* basic_synchronized_pool_resource<Options>::do_allocate(std::size_t bytes, std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return base_.allocate_impl(bytes, alignment);
+}
+
+template <pool_options Options>
+void basic_synchronized_pool_resource<Options>::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    base_.deallocate_impl(p, bytes, alignment);
+}
+
+template <pool_options Options>
+void basic_synchronized_pool_resource<Options>::do_allocate_bulk(std::size_t bytes, std::size_t alignment,
+                                                                 std::size_t count, void** out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    base_.allocate_bulk(bytes, alignment, count, out);
+}
+
+template <pool_options Options>
+void basic_synchronized_pool_resource<Options>::do_deallocate_bulk(void* const* ptrs, std::size_t count,
+                                                                   std::size_t bytes, std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    base_.deallocate_bulk(ptrs, count, bytes, alignment);
+}
+
+template <pool_options Options>
+std::size_t basic_synchronized_pool_resource<Options>::release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return base_.release();
+}
+
+template <pool_options Options>
+std::size_t basic_synchronized_pool_resource<Options>::trim(std::size_t target_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return base_.trim(target_bytes);
+}
+
+template <pool_options Options>
+std::size_t basic_synchronized_pool_resource<Options>::decay() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return base_.decay();
+}
+
+template <pool_options Options>
+pool_stats basic_synchronized_pool_resource<Options>::stats() requires (Options.enable_stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return base_.stats();
+}
+
+template <pool_options Options>
+bool basic_synchronized_pool_resource<Options>::deallocate_unsized(void* p)
+    requires (Options.size_class_spans) {
+    // 不属于本资源的指针无需加锁
+    if (!base_.owns(p)) {
+        return !p;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return base_.deallocate_unsized(p);
+}
+
+template <pool_options Options>
+bool basic_synchronized_pool_resource<Options>::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+// basic_unsynchronized_pool_resource 实现
+template <pool_options Options>
+basic_unsynchronized_pool_resource<Options>::basic_unsynchronized_pool_resource() = default;
+
+template <pool_options Options>
+basic_unsynchronized_pool_resource<Options>::basic_unsynchronized_pool_resource(std::pmr::memory_resource* upstream)
+    : base_(upstream) {}
+
+template <pool_options Options>
+void* basic_unsynchronized_pool_resource<Options>::do_allocate(std::size_t bytes, std::size_t alignment) {
+    return base_.allocate_impl(bytes, alignment);
+}
+
+template <pool_options Options>
+void basic_unsynchronized_pool_resource<Options>::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    base_.deallocate_impl(p, bytes, alignment);
+}
+
+template <pool_options Options>
+bool basic_unsynchronized_pool_resource<Options>::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+// 默认配置在库中显式实例化
+extern template class basic_sgi_pool_resource_base<>;
+extern template class basic_synchronized_pool_resource<>;
+extern template class basic_unsynchronized_pool_resource<>;
+
+} // namespace sgi_pmr
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace sgi_pmr {
+
+/**
+ * @brief 按请求整体回收的单调分配内存资源
+ *
+ * 从上游（例如 SGI 池资源）申请固定大小的内存块，在块内以移动指针的方式分配，
+ * 释放单个对象不做任何事（只有最近一次分配可以退回）。
+ * reset() 把本轮用过的块整段拼接到缓存链表上，开销与分配的对象数量无关；
+ * 缓存最多保留 max_cached_blocks 个块供下一轮直接使用，多出的块归还上游。
+ * 超过块大小的请求单独向上游申请，在 reset() 时归还。
+ * 与 std::pmr::monotonic_buffer_resource 一样不是线程安全的。
+ */
+class arena_resource : public std::pmr::memory_resource {
+public:
+    // 默认块大小，包含块头
+    static constexpr std::size_t DEFAULT_BLOCK_BYTES = std::size_t{64} << 10;
+
+    // reset() 之后默认保留的块数
+    static constexpr std::size_t DEFAULT_CACHED_BLOCKS = 4;
+
+private:
+    struct block;
+
+    std::pmr::memory_resource* upstream_;
+    const std::size_t block_bytes_;
+    const std::size_t max_cached_blocks_;
+
+    // 当前块中尚未分配的区间
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+
+    // 本轮使用的常规块，头部为当前块；last_used_ 为链表末尾，用于整段拼接
+    block* used_ = nullptr;
+    block* last_used_ = nullptr;
+    std::size_t used_count_ = 0;
+
+    // 本轮单独申请的大块
+    block* oversized_ = nullptr;
+
+    // 上一轮留下的常规块
+    block* cached_ = nullptr;
+    std::size_t cached_count_ = 0;
+
+    /**
+     * @brief 取一个缓存的块或向上游申请新块作为当前块
+     */
+    void next_block();
+
+    /**
+     * @brief 把链表中的块全部归还上游
+     */
+    void free_blocks(block* list) noexcept;
+
+public:
+    explicit arena_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource(),
+                            std::size_t block_bytes = DEFAULT_BLOCK_BYTES,
+                            std::size_t max_cached_blocks = DEFAULT_CACHED_BLOCKS);
+    ~arena_resource() override;
+
+    arena_resource(const arena_resource&) = delete;
+    arena_resource& operator=(const arena_resource&) = delete;
+
+    /**
+     * @brief 上游内存资源
+     */
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return upstream_;
+    }
+
+    /**
+     * @brief 回收本轮分配的全部内存，之前分配的指针全部失效
+     *
+     * 常规块整段移入缓存，只有超出缓存上限的块和大块逐个归还上游。
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief 回收全部内存并把缓存的块也归还上游
+     */
+    void release() noexcept;
+
+    /**
+     * @brief 本轮使用的常规块数量
+     */
+    std::size_t block_count() const noexcept {
+        return used_count_;
+    }
+
+    /**
+     * @brief 缓存中等待下一轮使用的块数量
+     */
+    std::size_t cached_block_count() const noexcept {
+        return cached_count_;
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+} // namespace sgi_pmr
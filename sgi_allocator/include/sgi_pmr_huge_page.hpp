@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+namespace sgi_pmr {
+
+/**
+ * @brief 基于 mmap 的大页内存资源
+ *
+ * 以大块虚拟地址区域为单位向系统保留内存，并从中切分请求，
+ * 适合作为 SGI 池资源的上游，让内存块集中在少数大页上以减少 TLB 缺失。
+ * 区域优先使用 MAP_HUGETLB 映射；系统没有预留大页时退回普通映射，
+ * 并通过 madvise(MADV_HUGEPAGE) 请求透明大页；都不可用时使用普通页。
+ * 释放的块按地址有序合并后复用，其中完整的页通过 MADV_DONTNEED 归还系统。
+ * 不支持 mmap 的平台上区域改由 std::pmr::new_delete_resource() 提供。
+ */
+class huge_page_resource : public std::pmr::memory_resource {
+public:
+    // 大页大小，区域按此对齐
+    static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t{2} << 20;
+
+    // 默认区域大小
+    static constexpr std::size_t DEFAULT_REGION_BYTES = std::size_t{64} << 20;
+
+    // 区域内分配的最小粒度和默认对齐
+    static constexpr std::size_t BLOCK_ALIGN = 64;
+
+    /**
+     * @brief 区域实际使用的页类型
+     */
+    enum class page_kind {
+        hugetlb,        // MAP_HUGETLB 显式大页
+        transparent,    // madvise(MADV_HUGEPAGE) 透明大页
+        normal          // 普通页
+    };
+
+private:
+    struct region;
+    struct free_block;
+
+    const std::size_t region_bytes_;
+    mutable std::mutex mutex_;
+
+    // 所有保留的区域，区域头保存在区域起始处
+    region* regions_ = nullptr;
+
+    // 当前区域中尚未切分的区间
+    char* cursor_ = nullptr;
+    char* region_end_ = nullptr;
+
+    // 按地址有序的空闲块链表，块头保存在块起始处
+    free_block* free_blocks_ = nullptr;
+
+    std::size_t reserved_bytes_ = 0;
+    page_kind last_kind_ = page_kind::normal;
+
+    // 归还物理内存的粒度，映射过显式大页后为大页大小
+    std::size_t release_granularity_;
+
+    /**
+     * @brief 映射 bytes 字节，依次尝试显式大页、透明大页和普通页
+     */
+    void* map(std::size_t bytes, page_kind& kind);
+
+    /**
+     * @brief 保留一个新区域并作为当前区域
+     */
+    void add_region(std::size_t min_bytes);
+
+    /**
+     * @brief 从空闲块链表中首次适配一个块
+     */
+    void* take_free_block(std::size_t bytes, std::size_t alignment);
+
+    /**
+     * @brief 把块按地址插入空闲块链表，与相邻块合并，并释放其中完整页的物理内存
+     */
+    void insert_free_block(char* p, std::size_t bytes);
+
+public:
+    huge_page_resource();
+    explicit huge_page_resource(std::size_t region_bytes);
+    ~huge_page_resource() override;
+
+    huge_page_resource(const huge_page_resource&) = delete;
+    huge_page_resource& operator=(const huge_page_resource&) = delete;
+
+    /**
+     * @brief 最近一次映射实际使用的页类型
+     */
+    page_kind last_page_kind() const noexcept;
+
+    /**
+     * @brief 已保留的虚拟地址总量
+     */
+    std::size_t reserved_bytes() const noexcept;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+} // namespace sgi_pmr
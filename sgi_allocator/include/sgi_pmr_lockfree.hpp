@@ -0,0 +1,326 @@
+#pragma once
+
+#include "sgi_pmr_allocator.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+
+// x86-64 上编译时启用 -mcx16（CMake 默认打开）即可用 cmpxchg16b 一次交换两个字长
+#if defined(__x86_64__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#define SGI_PMR_HAS_DWCAS 1
+#else
+#define SGI_PMR_HAS_DWCAS 0
+#endif
+
+namespace sgi_pmr {
+
+namespace detail {
+
+// 空闲对象首个字长保存下一个对象的地址。
+// 弹出时其他线程可能已经取走并改写了该对象，因此以原子方式访问；
+// 读到的过期值会被随后的 CAS（代数不同）拒绝。
+inline std::atomic_ref<void*> atomic_next_of(void* p) noexcept {
+    return std::atomic_ref<void*>(*static_cast<void**>(p));
+}
+
+/**
+ * @brief Treiber 栈的栈顶：指针加上每次修改递增的代数，CAS 同时比较两者以避免 ABA 问题
+ *
+ * 支持 16 字节 CAS 时指针和 64 位代数各占一个字长，代数实际上不会回绕；
+ * 否则打包在一个 64 位字中，低 48 位存放指针、高 16 位存放代数，
+ * 此时只能表示低 48 位的地址，入栈前需要用 fits 检查。
+ */
+class tagged_top {
+public:
+    struct snapshot {
+        void* pointer;
+        std::uint64_t tag;
+    };
+
+#if SGI_PMR_HAS_DWCAS
+    // 指针不受位数限制
+    static constexpr bool FULL_POINTER = true;
+
+    static constexpr bool fits(const void*) noexcept { return true; }
+
+    /**
+     * @brief 读取栈顶，两个字长分开读取，读到不一致的组合时随后的 CAS 会失败并返回当前值
+     */
+    snapshot load(std::memory_order order) const noexcept {
+        std::uint64_t tag = tag_.load(order);
+        std::uint64_t pointer = pointer_.load(order);
+        return {reinterpret_cast<void*>(pointer), tag};
+    }
+
+    /**
+     * @brief 栈顶仍为 expected 时换成 desired 并递增代数；失败时把当前值写回 expected。
+     * lock cmpxchg16b 是完整的内存屏障，不区分内存序
+     */
+    bool compare_exchange(snapshot& expected, void* desired, std::memory_order, std::memory_order) noexcept {
+        unsigned __int128 old = pack(expected.pointer, expected.tag);
+        unsigned __int128 seen = __sync_val_compare_and_swap(reinterpret_cast<unsigned __int128*>(this), old,
+                                                             pack(desired, expected.tag + 1));
+        if (seen == old) return true;
+        expected = {reinterpret_cast<void*>(static_cast<std::uint64_t>(seen)), static_cast<std::uint64_t>(seen >> 64)};
+        return false;
+    }
+
+private:
+    // 低地址的字长存放指针，与 pack 的布局一致
+    alignas(16) std::atomic<std::uint64_t> pointer_{0};
+    std::atomic<std::uint64_t> tag_{0};
+
+    static unsigned __int128 pack(void* p, std::uint64_t tag) noexcept {
+        return (static_cast<unsigned __int128>(tag) << 64) | reinterpret_cast<std::uint64_t>(p);
+    }
+#else
+    static_assert(sizeof(void*) == 8, "tagged pointer requires a 64-bit address space");
+
+    static constexpr bool FULL_POINTER = false;
+
+    /**
+     * @brief 地址能否用低 48 位表示；启用 5 级页表的内核可能返回更高的地址
+     */
+    static bool fits(const void* p) noexcept {
+        return (reinterpret_cast<std::uint64_t>(p) & ~POINTER_MASK) == 0;
+    }
+
+    snapshot load(std::memory_order order) const noexcept {
+        return unpack(word_.load(order));
+    }
+
+    bool compare_exchange(snapshot& expected, void* desired, std::memory_order success,
+                          std::memory_order failure) noexcept {
+        std::uint64_t old = pack(expected.pointer, expected.tag);
+        if (word_.compare_exchange_weak(old, pack(desired, expected.tag + 1), success, failure)) {
+            return true;
+        }
+        expected = unpack(old);
+        return false;
+    }
+
+private:
+    static constexpr unsigned TAG_SHIFT = 48;
+    static constexpr std::uint64_t POINTER_MASK = (std::uint64_t{1} << TAG_SHIFT) - 1;
+
+    std::atomic<std::uint64_t> word_{0};
+
+    // 代数只保留 16 位，回绕后仍需要恰好相隔 65536 次修改才会误判
+    static std::uint64_t pack(void* p, std::uint64_t tag) noexcept {
+        return (tag << TAG_SHIFT) | (reinterpret_cast<std::uint64_t>(p) & POINTER_MASK);
+    }
+
+    static snapshot unpack(std::uint64_t word) noexcept {
+        return {reinterpret_cast<void*>(word & POINTER_MASK), word >> TAG_SHIFT};
+    }
+#endif
+};
+
+} // namespace detail
+
+/**
+ * @brief 无锁空闲链表的同步池资源
+ *
+ * 每个大小类的空闲链表是一个独立的 Treiber 栈，栈顶指针带有代数计数器以避免 ABA 问题
+ * （见 detail::tagged_top）。
+ * 普通的分配和释放只对各自大小类的栈顶做 CAS，不同大小类之间互不竞争；
+ * 只有栈为空需要 refill 时才获取互斥锁，从 sgi_pool_resource_base 切分新对象。
+ * 弹出时可能读取刚被其他线程取走的对象，因此内存块只在资源销毁时归还，不提供 trim。
+ */
+template <pool_options Options = pool_options{}>
+class basic_lockfree_pool_resource : public std::pmr::memory_resource {
+public:
+    // 每次 refill 从共享池取出的对象数
+    static constexpr std::size_t REFILL_BATCH = Options.refill_batch;
+
+private:
+    using base_type = basic_sgi_pool_resource_base<Options>;
+
+    // 无锁路径的计数器，多个线程同时写入
+    struct head_counters {
+        detail::stat_counter allocations;
+        detail::stat_counter deallocations;
+    };
+
+    // 每个栈顶独占一个缓存行，避免伪共享；计数器与栈顶同一缓存行，不额外引入共享
+    struct alignas(64) free_list_head {
+        detail::tagged_top top;
+        [[no_unique_address]] std::conditional_t<Options.enable_stats, head_counters, detail::no_stats> counters;
+    };
+
+    free_list_head heads_[base_type::size_class_count()];
+
+    // 仅用于 refill 和大对象路径
+    base_type base_;
+    std::mutex refill_mutex_;
+
+    /**
+     * @brief 从栈顶弹出一个对象，栈为空时返回 nullptr
+     */
+    void* pop(std::size_t index) noexcept;
+
+    /**
+     * @brief 把 head 到 tail 的整段链表压入栈顶
+     */
+    void push(std::size_t index, void* head, void* tail) noexcept;
+
+    /**
+     * @brief 栈为空时从共享池补充对象
+     */
+    void* refill(std::size_t index);
+
+public:
+    basic_lockfree_pool_resource();
+    explicit basic_lockfree_pool_resource(std::pmr::memory_resource* upstream);
+    ~basic_lockfree_pool_resource() override = default;
+
+    basic_lockfree_pool_resource(const basic_lockfree_pool_resource&) = delete;
+    basic_lockfree_pool_resource& operator=(const basic_lockfree_pool_resource&) = delete;
+
+    /**
+     * @brief 上游内存资源
+     */
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return base_.upstream_resource();
+    }
+
+    /**
+     * @brief 统计快照，仅在 Options.enable_stats 为 true 时可用
+     *
+     * 分配和释放次数来自无锁路径；refill、峰值和空闲链表长度描述共享池一侧，
+     * 无锁栈中的对象在共享池看来处于使用中。
+     */
+    pool_stats stats() requires (Options.enable_stats);
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+using lockfree_pool_resource = basic_lockfree_pool_resource<>;
+
+// basic_lockfree_pool_resource 实现
+template <pool_options Options>
+basic_lockfree_pool_resource<Options>::basic_lockfree_pool_resource() = default;
+
+template <pool_options Options>
+basic_lockfree_pool_resource<Options>::basic_lockfree_pool_resource(std::pmr::memory_resource* upstream)
+    : base_(upstream) {}
+
+template <pool_options Options>
+void* basic_lockfree_pool_resource<Options>::pop(std::size_t index) noexcept {
+    detail::tagged_top& top = heads_[index].top;
+    detail::tagged_top::snapshot old = top.load(std::memory_order_acquire);
+
+    for (;;) {
+        void* p = old.pointer;
+        if (!p) return nullptr;
+
+        // 内存块在资源销毁前不会归还系统，读取 p 的链接总是安全的
+        void* next = detail::atomic_next_of(p).load(std::memory_order_relaxed);
+        if (top.compare_exchange(old, next, std::memory_order_acquire, std::memory_order_acquire)) {
+            return p;
+        }
+    }
+}
+
+template <pool_options Options>
+void basic_lockfree_pool_resource<Options>::push(std::size_t index, void* head, void* tail) noexcept {
+    detail::tagged_top& top = heads_[index].top;
+    detail::tagged_top::snapshot old = top.load(std::memory_order_relaxed);
+
+    do {
+        detail::atomic_next_of(tail).store(old.pointer, std::memory_order_relaxed);
+    } while (!top.compare_exchange(old, head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+template <pool_options Options>
+void* basic_lockfree_pool_resource<Options>::refill(std::size_t index) {
+    std::lock_guard<std::mutex> lock(refill_mutex_);
+
+    // 等待锁期间其他线程可能已经补充过
+    if (void* p = pop(index)) {
+        return p;
+    }
+
+    void* head;
+    void* tail;
+    base_.allocate_chain(index, REFILL_BATCH, head, tail);
+
+    // 栈顶只能表示低 48 位地址时，拒绝超出范围的对象，而不是在入栈时截断指针
+    if constexpr (!detail::tagged_top::FULL_POINTER) {
+        for (void* p = head;; p = *static_cast<void**>(p)) {
+            if (!detail::tagged_top::fits(p)) {
+                base_.deallocate_chain(index, head, tail);
+                throw std::bad_alloc();
+            }
+            if (p == tail) break;
+        }
+    }
+
+    // 第一个对象返回给调用者，其余压入栈
+    void* result = head;
+    if (head != tail) {
+        push(index, *static_cast<void**>(head), tail);
+    }
+    return result;
+}
+
+template <pool_options Options>
+void* basic_lockfree_pool_resource<Options>::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (!base_type::is_pooled(bytes, alignment)) {
+        std::lock_guard<std::mutex> lock(refill_mutex_);
+        return base_.allocate_impl(bytes, alignment);
+    }
+
+    std::size_t index = base_type::size_class_index(bytes, alignment);
+    void* p = pop(index);
+    if (!p) {
+        p = refill(index);
+    }
+    // 只统计成功的分配，refill 抛出 bad_alloc 时不计数
+    if constexpr (Options.enable_stats) {
+        heads_[index].counters.allocations.atomic_add();
+    }
+    return p;
+}
+
+template <pool_options Options>
+void basic_lockfree_pool_resource<Options>::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    if (!p) return;
+
+    if (!base_type::is_pooled(bytes, alignment)) {
+        std::lock_guard<std::mutex> lock(refill_mutex_);
+        base_.deallocate_impl(p, bytes, alignment);
+        return;
+    }
+
+    std::size_t index = base_type::size_class_index(bytes, alignment);
+    if constexpr (Options.enable_stats) {
+        heads_[index].counters.deallocations.atomic_add();
+    }
+    push(index, p, p);
+}
+
+template <pool_options Options>
+pool_stats basic_lockfree_pool_resource<Options>::stats() requires (Options.enable_stats) {
+    std::lock_guard<std::mutex> lock(refill_mutex_);
+    pool_stats result = base_.stats();
+    for (std::size_t i = 0; i < base_type::size_class_count(); ++i) {
+        result.size_classes[i].allocations = heads_[i].counters.allocations.load();
+        result.size_classes[i].deallocations = heads_[i].counters.deallocations.load();
+    }
+    return result;
+}
+
+template <pool_options Options>
+bool basic_lockfree_pool_resource<Options>::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+extern template class basic_lockfree_pool_resource<>;
+
+} // namespace sgi_pmr
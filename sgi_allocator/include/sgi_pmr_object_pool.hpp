@@ -0,0 +1,160 @@
+#pragma once
+
+#include "sgi_pmr_allocator.hpp"
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace sgi_pmr {
+
+/**
+ * @brief 大小类在编译期确定的标准分配器
+ *
+ * 直接引用一个 basic_sgi_pool_resource_base，不经过 std::pmr::memory_resource 的虚函数；
+ * sizeof(T) 和 alignof(T) 对应的大小类索引是编译期常量，单个对象的分配和释放
+ * 内联为一次空闲链表的弹出或压入。rebind 到容器的节点类型后共用同一个池，
+ * 因此可以作为 std::list、std::map 等节点容器的分配器。
+ * 与 unsynchronized_pool_resource 一样不是线程安全的。
+ */
+template <typename T, pool_options Options = pool_options{}>
+class static_pool_allocator {
+public:
+    using value_type = T;
+    using pool_type = basic_sgi_pool_resource_base<Options>;
+
+    // 模板含非类型参数，allocator_traits 无法自动推导 rebind
+    template <typename U>
+    struct rebind {
+        using other = static_pool_allocator<U, Options>;
+    };
+
+private:
+    // 单个对象是否走空闲链表，以及对应的大小类
+    static constexpr bool POOLED = pool_type::is_pooled(sizeof(T), alignof(T));
+    static constexpr std::size_t INDEX = POOLED ? pool_type::size_class_index(sizeof(T), alignof(T)) : 0;
+
+    pool_type* pool_;
+
+public:
+    explicit static_pool_allocator(pool_type* pool) noexcept : pool_(pool) {}
+
+    template <typename U>
+    static_pool_allocator(const static_pool_allocator<U, Options>& other) noexcept
+        : pool_(other.pool()) {}
+
+    T* allocate(std::size_t n) {
+        if constexpr (POOLED) {
+            if (n == 1) [[likely]] {
+                return static_cast<T*>(pool_->allocate_class(INDEX));
+            }
+        }
+        return static_cast<T*>(pool_->allocate_impl(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if constexpr (POOLED) {
+            if (n == 1) [[likely]] {
+                pool_->deallocate_class(INDEX, p);
+                return;
+            }
+        }
+        pool_->deallocate_impl(p, n * sizeof(T), alignof(T));
+    }
+
+    pool_type* pool() const noexcept { return pool_; }
+
+    template <typename U>
+    bool operator==(const static_pool_allocator<U, Options>& other) const noexcept {
+        return pool_ == other.pool();
+    }
+
+    template <typename U>
+    bool operator!=(const static_pool_allocator<U, Options>& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief 单一类型的对象池
+ *
+ * 持有一个 basic_sgi_pool_resource_base，通过 static_pool_allocator 分配 T，
+ * 并提供构造和销毁对象的辅助函数。get_allocator() 返回的分配器可以交给节点容器，
+ * 与对象池共用内存块。非线程安全。
+ */
+template <typename T, pool_options Options = pool_options{}>
+class object_pool {
+public:
+    using allocator_type = static_pool_allocator<T, Options>;
+    using pool_type = typename allocator_type::pool_type;
+
+private:
+    pool_type pool_;
+
+public:
+    object_pool() = default;
+    explicit object_pool(std::pmr::memory_resource* upstream) : pool_(upstream) {}
+
+    object_pool(const object_pool&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+
+    /**
+     * @brief 分配一个未构造的 T
+     */
+    T* allocate() {
+        return get_allocator().allocate(1);
+    }
+
+    /**
+     * @brief 归还由 allocate 取得的未构造（或已析构）的 T
+     */
+    void deallocate(T* p) noexcept {
+        get_allocator().deallocate(p, 1);
+    }
+
+    /**
+     * @brief 分配并构造一个 T，构造抛出异常时归还内存
+     */
+    template <typename... Args>
+    T* construct(Args&&... args) {
+        T* p = allocate();
+        try {
+            return std::construct_at(p, std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(p);
+            throw;
+        }
+    }
+
+    /**
+     * @brief 析构并归还由 construct 创建的对象，p 为空时什么也不做
+     */
+    void destroy(T* p) noexcept {
+        if (!p) return;
+        std::destroy_at(p);
+        deallocate(p);
+    }
+
+    /**
+     * @brief 与对象池共用内存块的分配器
+     */
+    allocator_type get_allocator() noexcept {
+        return allocator_type(&pool_);
+    }
+
+    /**
+     * @brief 底层的池
+     */
+    pool_type& pool() noexcept {
+        return pool_;
+    }
+
+    /**
+     * @brief 把所有完全空闲的内存块归还上游，返回归还的字节数
+     */
+    std::size_t release() {
+        return pool_.release();
+    }
+};
+
+} // namespace sgi_pmr
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+namespace sgi_pmr {
+
+namespace detail {
+
+// 页映射和按页对齐的 span 使用的逻辑页大小，与系统页大小无关
+inline constexpr unsigned PAGE_SHIFT = 12;
+inline constexpr std::size_t PAGE_SIZE = std::size_t{1} << PAGE_SHIFT;
+
+// 定义在 sgi_pmr_page_map.hpp 中，只有实际使用页映射的代码才需要包含
+template <typename T>
+class page_map;
+
+} // namespace detail
+
+} // namespace sgi_pmr
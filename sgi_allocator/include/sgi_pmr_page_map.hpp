@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include "sgi_pmr_page.hpp"
+
+namespace sgi_pmr {
+
+namespace detail {
+
+/**
+ * @brief 三层基数树实现的页映射，把地址所在的页映射到一个小值（例如所属分片）
+ *
+ * 覆盖 48 位地址空间，中间层和叶子层在首次写入时分配，之后直到销毁都不会释放，
+ * 因此查找无需加锁：只沿着以 acquire 读取的节点指针向下走。
+ * 不同线程可以并发写入不相交的页；同一页的写入和读取之间需要由调用方建立先后关系
+ * （例如对象地址在写入之后才交给其他线程）。
+ * 节点从构造时指定的内存资源申请，替换全局 malloc 时可以避免递归进入自身。
+ */
+template <typename T>
+class page_map {
+    static_assert(std::is_trivially_copyable_v<T>, "page_map values are stored in atomics");
+
+    static constexpr unsigned ADDRESS_BITS = 48;
+    static constexpr unsigned PAGE_BITS = ADDRESS_BITS - PAGE_SHIFT;
+    static constexpr unsigned LEAF_BITS = PAGE_BITS / 3;
+    static constexpr unsigned MID_BITS = PAGE_BITS / 3;
+    static constexpr unsigned ROOT_BITS = PAGE_BITS - LEAF_BITS - MID_BITS;
+
+    struct leaf {
+        std::atomic<T> values[std::size_t{1} << LEAF_BITS]{};
+    };
+
+    struct mid {
+        std::atomic<leaf*> leaves[std::size_t{1} << MID_BITS]{};
+    };
+
+    std::atomic<mid*> root_[std::size_t{1} << ROOT_BITS]{};
+
+    // 中间层和叶子层节点的来源
+    std::pmr::memory_resource* nodes_;
+
+    static std::uintptr_t page_of(const void* p) noexcept {
+        return reinterpret_cast<std::uintptr_t>(p) >> PAGE_SHIFT;
+    }
+
+    /**
+     * @brief 取出或安装子节点，多个线程同时安装时只保留一个
+     */
+    template <typename Node>
+    Node* ensure(std::atomic<Node*>& slot) {
+        Node* node = slot.load(std::memory_order_acquire);
+        if (node) return node;
+
+        Node* fresh = ::new (nodes_->allocate(sizeof(Node), alignof(Node))) Node;
+        if (slot.compare_exchange_strong(node, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return fresh;
+        }
+        destroy(fresh);
+        return node;
+    }
+
+    template <typename Node>
+    void destroy(Node* node) noexcept {
+        node->~Node();
+        nodes_->deallocate(node, sizeof(Node), alignof(Node));
+    }
+
+public:
+    explicit page_map(std::pmr::memory_resource* nodes = std::pmr::new_delete_resource()) noexcept
+        : nodes_(nodes) {}
+
+    ~page_map() {
+        for (auto& m : root_) {
+            mid* node = m.load(std::memory_order_relaxed);
+            if (!node) continue;
+            for (auto& l : node->leaves) {
+                if (leaf* child = l.load(std::memory_order_relaxed)) {
+                    destroy(child);
+                }
+            }
+            destroy(node);
+        }
+    }
+
+    page_map(const page_map&) = delete;
+    page_map& operator=(const page_map&) = delete;
+
+    /**
+     * @brief 把 [p, p + bytes) 覆盖的每一页映射到 value，需要时分配节点，失败时抛出 std::bad_alloc
+     */
+    void set_range(const void* p, std::size_t bytes, T value) {
+        if (bytes == 0) return;
+
+        std::uintptr_t first = page_of(p);
+        std::uintptr_t last = page_of(static_cast<const char*>(p) + bytes - 1);
+        for (std::uintptr_t page = first; page <= last; ++page) {
+            mid* m = ensure(root_[page >> (LEAF_BITS + MID_BITS)]);
+            leaf* l = ensure(m->leaves[(page >> LEAF_BITS) & ((std::uintptr_t{1} << MID_BITS) - 1)]);
+            l->values[page & ((std::uintptr_t{1} << LEAF_BITS) - 1)].store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 把 [p, p + bytes) 覆盖的每一页恢复为 T{}，不分配节点
+     */
+    void clear_range(const void* p, std::size_t bytes) noexcept {
+        if (bytes == 0) return;
+
+        std::uintptr_t first = page_of(p);
+        std::uintptr_t last = page_of(static_cast<const char*>(p) + bytes - 1);
+        for (std::uintptr_t page = first; page <= last; ++page) {
+            mid* m = root_[page >> (LEAF_BITS + MID_BITS)].load(std::memory_order_acquire);
+            if (!m) continue;
+            leaf* l = m->leaves[(page >> LEAF_BITS) & ((std::uintptr_t{1} << MID_BITS) - 1)].load(std::memory_order_acquire);
+            if (!l) continue;
+            l->values[page & ((std::uintptr_t{1} << LEAF_BITS) - 1)].store(T{}, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 查找地址所在页的映射值，未映射时返回 T{}
+     */
+    T get(const void* p) const noexcept {
+        std::uintptr_t page = page_of(p);
+        mid* m = root_[page >> (LEAF_BITS + MID_BITS)].load(std::memory_order_acquire);
+        if (!m) return T{};
+        leaf* l = m->leaves[(page >> LEAF_BITS) & ((std::uintptr_t{1} << MID_BITS) - 1)].load(std::memory_order_acquire);
+        if (!l) return T{};
+        return l->values[page & ((std::uintptr_t{1} << LEAF_BITS) - 1)].load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief 登记内存块归属的上游包装
+ *
+ * 对齐不小于 chunk_alignment 的请求视为池的内存块：向真实上游申请按页对齐、页大小整数倍的内存，
+ * 并把其覆盖的页在页映射中标记为 tag（例如所属分片），释放时清除标记。
+ * 其他请求（池自身记录内存块的数组等簿记数据）原样转发给上游，既不按页取整也不登记。
+ */
+template <typename T>
+class page_owner_resource : public std::pmr::memory_resource {
+    std::pmr::memory_resource* upstream_;
+    page_map<T>* owners_;
+    T tag_;
+    std::size_t chunk_alignment_;
+
+    static std::size_t page_round_up(std::size_t bytes) noexcept {
+        return (bytes + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    }
+
+public:
+    page_owner_resource(std::pmr::memory_resource* upstream, page_map<T>* owners, T tag,
+                        std::size_t chunk_alignment)
+        : upstream_(upstream), owners_(owners), tag_(tag), chunk_alignment_(chunk_alignment) {}
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (alignment < chunk_alignment_) {
+            return upstream_->allocate(bytes, alignment);
+        }
+
+        std::size_t size = page_round_up(bytes);
+        void* p = upstream_->allocate(size, std::max(alignment, PAGE_SIZE));
+        try {
+            owners_->set_range(p, size, tag_);
+        } catch (...) {
+            upstream_->deallocate(p, size, std::max(alignment, PAGE_SIZE));
+            throw;
+        }
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (alignment < chunk_alignment_) {
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+
+        std::size_t size = page_round_up(bytes);
+        owners_->clear_range(p, size);
+        upstream_->deallocate(p, size, std::max(alignment, PAGE_SIZE));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+} // namespace detail
+
+} // namespace sgi_pmr
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace sgi_pmr {
+
+/**
+ * @brief 采样堆分析器
+ *
+ * 池资源的 pool_options::sample_interval_bytes 非零时，各分配路径（包括批量和链式接口）平均每分配
+ * 这么多字节抽取一次分配（间隔服从指数分布，大对象被抽中的概率更高），用 backtrace 记录调用栈，
+ * 并登记到全进程共享的存活对象表中；释放被抽中的对象时从表中移除。
+ * 需要时把按调用栈汇总的存活内存输出为折叠栈（flamegraph.pl 的输入）
+ * 或 gperftools 的文本堆剖析格式（pprof 可以直接读取）。
+ *
+ * 释放路径先查询一个无锁的计数过滤器，只有可能被抽中的地址才加锁查表。
+ * 内部的簿记使用全局堆，不经过任何池资源。
+ */
+class heap_profiler {
+public:
+    // 每个调用栈最多记录的帧数
+    static constexpr std::size_t MAX_FRAMES = 32;
+
+    /**
+     * @brief 同一调用栈的采样汇总
+     */
+    struct stack_sample {
+        std::vector<void*> frames;          // 调用栈，从分配点所在函数开始向外
+        std::uint64_t live_count = 0;       // 仍存活的被抽中对象数
+        std::uint64_t live_bytes = 0;       // 仍存活的被抽中对象的请求字节数
+        std::uint64_t total_count = 0;      // 累计被抽中的对象数
+        std::uint64_t total_bytes = 0;      // 累计被抽中的对象的请求字节数
+        double live_estimate = 0;           // 按抽样概率放大后的存活字节估计
+    };
+
+private:
+    // 计数过滤器的槽数，按地址哈希，槽值为落在该槽的被抽中存活对象数
+    static constexpr std::size_t FILTER_SLOTS = std::size_t{1} << 16;
+
+    struct live_object {
+        std::size_t bytes;
+        double weight;
+        stack_sample* stack;
+    };
+
+    mutable std::mutex mutex_;
+
+    // 调用栈到汇总的映射，节点地址稳定，可以被 live_ 引用
+    std::map<std::vector<void*>, stack_sample> stacks_;
+
+    // 被抽中且尚未释放的对象
+    std::unordered_map<const void*, live_object> live_;
+
+    // 最近一次采样使用的平均间隔，写入 pprof 输出的头部
+    std::size_t interval_ = 0;
+
+    std::atomic<std::uint16_t> filter_[FILTER_SLOTS]{};
+
+    static std::size_t filter_slot(const void* p) noexcept {
+        auto value = reinterpret_cast<std::uintptr_t>(p);
+        return static_cast<std::size_t>((value >> 3) * 0x9E3779B97F4A7C15ull >> 48) & (FILTER_SLOTS - 1);
+    }
+
+    /**
+     * @brief 移除存活对象，调用方持有 mutex_
+     */
+    bool erase_live(const void* p) noexcept;
+
+    /**
+     * @brief 过滤器命中后加锁移除存活对象
+     */
+    void erase_sampled(const void* p) noexcept;
+
+public:
+    heap_profiler();
+
+    heap_profiler(const heap_profiler&) = delete;
+    heap_profiler& operator=(const heap_profiler&) = delete;
+
+    /**
+     * @brief 全进程共享的分析器，开启采样的池资源都登记到这里
+     */
+    static heap_profiler& global();
+
+    /**
+     * @brief 生成下一个采样间隔（字节），服从均值为 mean 的指数分布
+     *
+     * state 为调用方持有的随机数状态，不能为 0。
+     */
+    static std::size_t next_sample_interval(std::uint64_t& state, std::size_t mean) noexcept;
+
+    /**
+     * @brief 登记一次被抽中的分配，在此处记录调用栈
+     *
+     * interval 为平均采样间隔，用于估计该对象代表的字节数。
+     * 调用栈从调用方开始记录；分配器内部被内联的程度随编译选项变化，只跳过本函数自身的帧。
+     */
+    void record_allocation(const void* p, std::size_t bytes, std::size_t interval);
+
+    /**
+     * @brief 释放路径调用：对象曾被抽中时从存活表中移除
+     */
+    void record_deallocation(const void* p) noexcept {
+        if (filter_[filter_slot(p)].load(std::memory_order_relaxed) != 0) {
+            erase_sampled(p);
+        }
+    }
+
+    /**
+     * @brief 被抽中且尚未释放的对象数
+     */
+    std::size_t live_samples() const;
+
+    /**
+     * @brief 按调用栈汇总的采样结果，按存活字节估计从大到小排序
+     */
+    std::vector<stack_sample> snapshot() const;
+
+    /**
+     * @brief 输出折叠栈：每个调用栈一行，帧从外到内以分号分隔，最后是存活字节估计
+     */
+    void write_folded(std::ostream& out) const;
+
+    /**
+     * @brief 输出 gperftools 文本堆剖析（heap_v2），附带 /proc/self/maps 供 pprof 符号化
+     */
+    void write_pprof(std::ostream& out) const;
+
+    /**
+     * @brief 丢弃全部采样结果
+     */
+    void clear();
+};
+
+} // namespace sgi_pmr
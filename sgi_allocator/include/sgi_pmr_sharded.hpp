@@ -0,0 +1,221 @@
+#pragma once
+
+#include "sgi_pmr_allocator.hpp"
+#include "sgi_pmr_page_map.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sgi_pmr {
+
+/**
+ * @brief 分片的选择方式
+ */
+enum class shard_selection {
+    cpu,        // 按当前 CPU（sched_getcpu），不支持时退回线程哈希
+    thread      // 按线程标识的哈希
+};
+
+namespace detail {
+
+/**
+ * @brief 当前线程应使用的分片提示，调用方再对分片数取模
+ */
+std::size_t current_shard_hint(shard_selection selection) noexcept;
+
+} // namespace detail
+
+/**
+ * @brief 分片的同步池资源
+ *
+ * 持有 N 个独立的 sgi_pool_resource_base，每个分片有自己的互斥锁并独占缓存行。
+ * 分配按当前 CPU 或线程哈希选择分片，所选分片的锁被占用时依次尝试其他分片；
+ * 释放通过页映射查出对象所在内存块的分片，归还给该分片。
+ * 大对象不经过分片，直接交给上游。
+ * 与线程缓存相比，内存开销只随分片数而不随线程数增长。
+ */
+template <pool_options Options = pool_options{}>
+class basic_sharded_pool_resource : public std::pmr::memory_resource {
+private:
+    using base_type = basic_sgi_pool_resource_base<Options>;
+
+    struct alignas(64) shard {
+        detail::page_owner_resource<std::uint16_t> owner;
+        std::mutex mutex;
+        base_type base;
+
+        shard(std::pmr::memory_resource* upstream, detail::page_map<std::uint16_t>* owners, std::uint16_t tag)
+            : owner(upstream, owners, tag, base_type::chunk_alignment()), base(&owner) {}
+    };
+
+    // 页映射只登记内存块，内存块按对齐与分片的簿记数据区分
+    static_assert(base_type::chunk_alignment() > alignof(std::max_align_t),
+                  "max_pooled_alignment must exceed alignof(std::max_align_t)");
+
+    std::pmr::memory_resource* upstream_;
+    const shard_selection selection_;
+
+    // 页到分片编号加一的映射，0 表示不属于任何分片；必须比分片活得久
+    detail::page_map<std::uint16_t> owners_;
+    std::vector<std::unique_ptr<shard>> shards_;
+
+    /**
+     * @brief 选择分片并加锁，优先当前 CPU 或线程对应的分片
+     */
+    shard& lock_shard(std::unique_lock<std::mutex>& lock);
+
+public:
+    // 默认分片数，等于硬件线程数
+    static std::size_t default_shard_count() noexcept;
+
+    basic_sharded_pool_resource();
+    explicit basic_sharded_pool_resource(std::pmr::memory_resource* upstream);
+    basic_sharded_pool_resource(std::size_t shard_count, shard_selection selection,
+                                std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    ~basic_sharded_pool_resource() override;
+
+    basic_sharded_pool_resource(const basic_sharded_pool_resource&) = delete;
+    basic_sharded_pool_resource& operator=(const basic_sharded_pool_resource&) = delete;
+
+    /**
+     * @brief 上游内存资源
+     */
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return upstream_;
+    }
+
+    /**
+     * @brief 分片数量
+     */
+    std::size_t shard_count() const noexcept {
+        return shards_.size();
+    }
+
+    /**
+     * @brief 对象所属的分片，不属于任何分片（例如大对象）时返回 shard_count()
+     */
+    std::size_t shard_of(const void* p) const noexcept {
+        std::uint16_t tag = owners_.get(p);
+        return tag ? tag - 1 : shards_.size();
+    }
+
+    /**
+     * @brief 把每个分片中完全空闲的内存块归还上游，返回归还的字节数
+     */
+    std::size_t release();
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+using sharded_pool_resource = basic_sharded_pool_resource<>;
+
+// basic_sharded_pool_resource 实现
+template <pool_options Options>
+std::size_t basic_sharded_pool_resource<Options>::default_shard_count() noexcept {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 4 : n;
+}
+
+template <pool_options Options>
+basic_sharded_pool_resource<Options>::basic_sharded_pool_resource()
+    : basic_sharded_pool_resource(std::pmr::get_default_resource()) {}
+
+template <pool_options Options>
+basic_sharded_pool_resource<Options>::basic_sharded_pool_resource(std::pmr::memory_resource* upstream)
+    : basic_sharded_pool_resource(default_shard_count(), shard_selection::cpu, upstream) {}
+
+template <pool_options Options>
+basic_sharded_pool_resource<Options>::basic_sharded_pool_resource(std::size_t shard_count,
+                                                                  shard_selection selection,
+                                                                  std::pmr::memory_resource* upstream)
+    : upstream_(upstream), selection_(selection) {
+    // 分片编号存放在 16 位页映射中，0 保留给未映射
+    shard_count = std::clamp<std::size_t>(shard_count, 1, UINT16_MAX);
+    shards_.reserve(shard_count);
+    for (std::size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<shard>(upstream, &owners_, static_cast<std::uint16_t>(i + 1)));
+    }
+}
+
+template <pool_options Options>
+basic_sharded_pool_resource<Options>::~basic_sharded_pool_resource() {
+    // 先销毁分片，内存块归还时还要清除页映射
+    shards_.clear();
+}
+
+template <pool_options Options>
+auto basic_sharded_pool_resource<Options>::lock_shard(std::unique_lock<std::mutex>& lock) -> shard& {
+    std::size_t n = shards_.size();
+    std::size_t home = detail::current_shard_hint(selection_) % n;
+
+    // 首选分片被占用时尝试其他分片，都被占用时在首选分片上等待
+    for (std::size_t i = 0; i < n; ++i) {
+        shard& s = *shards_[(home + i) % n];
+        lock = std::unique_lock<std::mutex>(s.mutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            return s;
+        }
+    }
+
+    shard& s = *shards_[home];
+    lock = std::unique_lock<std::mutex>(s.mutex);
+    return s;
+}
+
+template <pool_options Options>
+std::size_t basic_sharded_pool_resource<Options>::release() {
+    std::size_t released = 0;
+    for (auto& s : shards_) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        released += s->base.release();
+    }
+    return released;
+}
+
+template <pool_options Options>
+void* basic_sharded_pool_resource<Options>::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (!base_type::is_pooled(bytes, alignment)) {
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    std::unique_lock<std::mutex> lock;
+    shard& s = lock_shard(lock);
+    return s.base.allocate_impl(bytes, alignment);
+}
+
+template <pool_options Options>
+void basic_sharded_pool_resource<Options>::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    if (!p) return;
+
+    if (!base_type::is_pooled(bytes, alignment)) {
+        upstream_->deallocate(p, bytes, alignment);
+        return;
+    }
+
+    // 池化对象总是来自某个分片的内存块；不属于本资源的指针直接忽略
+    std::size_t index = shard_of(p);
+    assert(index < shards_.size());
+    if (index >= shards_.size()) [[unlikely]] {
+        return;
+    }
+    shard& s = *shards_[index];
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.base.deallocate_impl(p, bytes, alignment);
+}
+
+template <pool_options Options>
+bool basic_sharded_pool_resource<Options>::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+extern template class basic_sharded_pool_resource<>;
+
+} // namespace sgi_pmr
@@ -0,0 +1,340 @@
+#pragma once
+
+#include "sgi_pmr_allocator.hpp"
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace sgi_pmr {
+
+namespace detail {
+
+// 线程与某个资源的线程缓存之间的绑定
+struct thread_cache_binding {
+    std::uint64_t owner_id;
+    void* owner;
+    void* cache;
+    void (*release)(void* owner, void* cache) noexcept;
+};
+
+/**
+ * @brief 为资源分配唯一标识并登记为存活
+ */
+std::uint64_t register_cache_owner();
+
+/**
+ * @brief 注销资源，此后退出的线程不会再访问它
+ */
+void unregister_cache_owner(std::uint64_t id) noexcept;
+
+/**
+ * @brief 在当前线程的绑定表中查找资源对应的缓存，找不到时返回 nullptr
+ */
+void* find_thread_cache(std::uint64_t owner_id) noexcept;
+
+/**
+ * @brief 记录当前线程与资源缓存的绑定，线程退出时调用 binding.release
+ */
+void bind_thread_cache(const thread_cache_binding& binding);
+
+// 最近一次使用的绑定，快速路径只需一次比较
+inline thread_local std::uint64_t tls_last_cache_owner = 0;
+inline thread_local void* tls_last_cache = nullptr;
+
+// 空闲对象首个字长保存下一个对象的地址
+inline void*& next_of(void* p) noexcept {
+    return *static_cast<void**>(p);
+}
+
+} // namespace detail
+
+/**
+ * @brief 带线程缓存的同步池资源
+ *
+ * 在共享的 sgi_pool_resource_base 之前，为每个线程维护一组有界的
+ * 按大小类划分的空闲链表（类似 tcmalloc 的线程缓存）。
+ * 线程内的分配和释放不加锁，只有本地缓存为空或超过上限时，
+ * 才获取共享锁与共享池批量交换对象。线程退出时其缓存整体归还共享池。
+ */
+template <pool_options Options = pool_options{}>
+class basic_thread_cached_pool_resource : public std::pmr::memory_resource {
+public:
+    // 每个大小类在线程缓存中最多保留的对象数
+    static constexpr std::size_t MAX_CACHED_OBJECTS = 64;
+
+    // 线程缓存与共享池之间一次交换的对象数
+    static constexpr std::size_t TRANSFER_BATCH = 32;
+
+private:
+    using base_type = basic_sgi_pool_resource_base<Options>;
+
+    // 线程缓存一侧的计数器，只由拥有缓存的线程写入
+    struct bin_counters {
+        detail::stat_counter allocations;
+        detail::stat_counter deallocations;
+    };
+
+    struct thread_cache {
+        struct bin {
+            void* head = nullptr;
+            std::size_t count = 0;
+            [[no_unique_address]] std::conditional_t<Options.enable_stats, bin_counters, detail::no_stats> counters;
+        };
+
+        bin bins[base_type::size_class_count()];
+        bool in_use = false;
+    };
+
+    base_type base_;
+    std::mutex mutex_;
+
+    // 所有线程缓存，线程退出后缓存留待其他线程复用，由 mutex_ 保护
+    std::vector<std::unique_ptr<thread_cache>> caches_;
+
+    // 资源的唯一标识，用于在线程退出时判断资源是否仍然存活
+    const std::uint64_t id_;
+
+    /**
+     * @brief 获取当前线程的缓存，首次使用时创建
+     */
+    thread_cache* local_cache();
+
+    /**
+     * @brief 为当前线程绑定一个空闲的缓存
+     */
+    thread_cache* acquire_cache();
+
+    /**
+     * @brief 把缓存中某个大小类的前 count 个对象归还共享池
+     */
+    void flush(thread_cache* cache, std::size_t index, std::size_t count);
+
+    /**
+     * @brief 线程退出时归还整个缓存
+     */
+    static void release_cache(void* owner, void* cache) noexcept;
+
+public:
+    basic_thread_cached_pool_resource();
+    explicit basic_thread_cached_pool_resource(std::pmr::memory_resource* upstream);
+    ~basic_thread_cached_pool_resource() override;
+
+    basic_thread_cached_pool_resource(const basic_thread_cached_pool_resource&) = delete;
+    basic_thread_cached_pool_resource& operator=(const basic_thread_cached_pool_resource&) = delete;
+
+    /**
+     * @brief 上游内存资源
+     */
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return base_.upstream_resource();
+    }
+
+    /**
+     * @brief 归还当前线程的缓存后，把所有完全空闲的内存块归还上游
+     *
+     * 其他线程缓存中的对象仍视为在使用，所在的内存块不会被归还。
+     */
+    std::size_t release() {
+        return trim(0);
+    }
+
+    /**
+     * @brief 归还当前线程的缓存后，归还完全空闲的内存块直到持有的字节数不超过 target_bytes
+     */
+    std::size_t trim(std::size_t target_bytes);
+
+    /**
+     * @brief 统计快照，仅在 Options.enable_stats 为 true 时可用
+     *
+     * 分配和释放次数是所有线程缓存的合计；refill、峰值和空闲链表长度描述共享池一侧，
+     * 线程缓存中的对象在共享池看来处于使用中。
+     */
+    pool_stats stats() requires (Options.enable_stats);
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+using thread_cached_pool_resource = basic_thread_cached_pool_resource<>;
+
+// basic_thread_cached_pool_resource 实现
+template <pool_options Options>
+basic_thread_cached_pool_resource<Options>::basic_thread_cached_pool_resource()
+    : basic_thread_cached_pool_resource(std::pmr::get_default_resource()) {}
+
+template <pool_options Options>
+basic_thread_cached_pool_resource<Options>::basic_thread_cached_pool_resource(std::pmr::memory_resource* upstream)
+    : base_(upstream), id_(detail::register_cache_owner()) {}
+
+template <pool_options Options>
+basic_thread_cached_pool_resource<Options>::~basic_thread_cached_pool_resource() {
+    // 注销后退出的线程不会再访问本资源；
+    // 线程缓存中的对象都来自 base_ 的内存块，随 base_ 一起释放
+    detail::unregister_cache_owner(id_);
+}
+
+template <pool_options Options>
+auto basic_thread_cached_pool_resource<Options>::local_cache() -> thread_cache* {
+    if (detail::tls_last_cache_owner == id_) {
+        return static_cast<thread_cache*>(detail::tls_last_cache);
+    }
+
+    if (void* cache = detail::find_thread_cache(id_)) {
+        return static_cast<thread_cache*>(cache);
+    }
+
+    return acquire_cache();
+}
+
+template <pool_options Options>
+auto basic_thread_cached_pool_resource<Options>::acquire_cache() -> thread_cache* {
+    thread_cache* cache = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& c : caches_) {
+            if (!c->in_use) {
+                cache = c.get();
+                break;
+            }
+        }
+        if (!cache) {
+            caches_.push_back(std::make_unique<thread_cache>());
+            cache = caches_.back().get();
+        }
+        cache->in_use = true;
+    }
+
+    detail::bind_thread_cache({id_, this, cache, &basic_thread_cached_pool_resource::release_cache});
+    return cache;
+}
+
+template <pool_options Options>
+void basic_thread_cached_pool_resource<Options>::flush(thread_cache* cache, std::size_t index, std::size_t count) {
+    typename thread_cache::bin& b = cache->bins[index];
+    if (count == 0 || !b.head) return;
+
+    // 截下前 count 个对象
+    void* head = b.head;
+    void* tail = head;
+    std::size_t n = 1;
+    while (n < count && detail::next_of(tail)) {
+        tail = detail::next_of(tail);
+        ++n;
+    }
+    b.head = detail::next_of(tail);
+    b.count -= n;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    base_.deallocate_chain(index, head, tail);
+}
+
+template <pool_options Options>
+void basic_thread_cached_pool_resource<Options>::release_cache(void* owner, void* cache) noexcept {
+    auto* self = static_cast<basic_thread_cached_pool_resource*>(owner);
+    auto* c = static_cast<thread_cache*>(cache);
+
+    for (std::size_t i = 0; i < base_type::size_class_count(); ++i) {
+        self->flush(c, i, c->bins[i].count);
+    }
+
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    c->in_use = false;
+}
+
+template <pool_options Options>
+void* basic_thread_cached_pool_resource<Options>::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (!base_type::is_pooled(bytes, alignment)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return base_.allocate_impl(bytes, alignment);
+    }
+
+    thread_cache* cache = local_cache();
+    std::size_t index = base_type::size_class_index(bytes, alignment);
+    typename thread_cache::bin& b = cache->bins[index];
+
+    if (!b.head) {
+        // 本地缓存为空，从共享池批量补充
+        void* head;
+        void* tail;
+        std::lock_guard<std::mutex> lock(mutex_);
+        b.count = base_.allocate_chain(index, TRANSFER_BATCH, head, tail);
+        b.head = head;
+    }
+
+    void* result = b.head;
+    b.head = detail::next_of(result);
+    --b.count;
+    if constexpr (Options.enable_stats) {
+        b.counters.allocations.add();
+    }
+    return result;
+}
+
+template <pool_options Options>
+void basic_thread_cached_pool_resource<Options>::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    if (!p) return;
+
+    if (!base_type::is_pooled(bytes, alignment)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        base_.deallocate_impl(p, bytes, alignment);
+        return;
+    }
+
+    thread_cache* cache = local_cache();
+    std::size_t index = base_type::size_class_index(bytes, alignment);
+    typename thread_cache::bin& b = cache->bins[index];
+
+    detail::next_of(p) = b.head;
+    b.head = p;
+    ++b.count;
+    if constexpr (Options.enable_stats) {
+        b.counters.deallocations.add();
+    }
+
+    // 超过上限时批量归还，保留一部分以应对后续分配
+    if (b.count > MAX_CACHED_OBJECTS) {
+        flush(cache, index, TRANSFER_BATCH);
+    }
+}
+
+template <pool_options Options>
+std::size_t basic_thread_cached_pool_resource<Options>::trim(std::size_t target_bytes) {
+    if (void* cache = detail::find_thread_cache(id_)) {
+        auto* c = static_cast<thread_cache*>(cache);
+        for (std::size_t i = 0; i < base_type::size_class_count(); ++i) {
+            flush(c, i, c->bins[i].count);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return base_.trim(target_bytes);
+}
+
+template <pool_options Options>
+pool_stats basic_thread_cached_pool_resource<Options>::stats() requires (Options.enable_stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pool_stats result = base_.stats();
+    for (std::size_t i = 0; i < base_type::size_class_count(); ++i) {
+        size_class_stats& s = result.size_classes[i];
+        s.allocations = 0;
+        s.deallocations = 0;
+        for (const auto& cache : caches_) {
+            s.allocations += cache->bins[i].counters.allocations.load();
+            s.deallocations += cache->bins[i].counters.deallocations.load();
+        }
+    }
+    return result;
+}
+
+template <pool_options Options>
+bool basic_thread_cached_pool_resource<Options>::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+extern template class basic_thread_cached_pool_resource<>;
+
+} // namespace sgi_pmr
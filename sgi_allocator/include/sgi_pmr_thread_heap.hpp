@@ -0,0 +1,269 @@
+#pragma once
+
+#include "sgi_pmr_allocator.hpp"
+#include "sgi_pmr_page_map.hpp"
+#include "sgi_pmr_thread_cache.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace sgi_pmr {
+
+/**
+ * @brief 每个线程独占一个堆、跨线程释放走远程队列的池资源
+ *
+ * 每个线程绑定一个私有的 sgi_pool_resource_base（堆），本线程的分配和释放完全不加锁。
+ * 释放时通过页映射查出对象所属的堆：属于本线程的堆时直接挂回空闲链表；
+ * 否则压入所属堆对应大小类的远程释放栈（无锁的多生产者单消费者栈），
+ * 所属线程在下一次分配该大小类时一次取走整个栈并拼接回空闲链表（类似 mimalloc）。
+ * 适用于一个线程分配、另一个线程释放的生产者/消费者负载。
+ *
+ * 线程退出后堆留待其他线程接管，期间其他线程仍可向它远程释放。
+ * 大对象不经过堆，直接交给上游。各个堆会并发地向上游申请内存块，上游必须线程安全。
+ */
+template <pool_options Options = pool_options{}>
+class basic_thread_heap_pool_resource : public std::pmr::memory_resource {
+private:
+    using base_type = basic_sgi_pool_resource_base<Options>;
+
+    struct heap {
+        detail::page_owner_resource<heap*> owner;
+        base_type base;
+        bool in_use = false;
+
+        // 其他线程释放的对象，每个大小类一个栈；独占缓存行，避免与本地分配路径伪共享
+        alignas(64) std::atomic<void*> remote_frees[base_type::size_class_count()]{};
+
+        heap(std::pmr::memory_resource* upstream, detail::page_map<heap*>* owners)
+            : owner(upstream, owners, this, base_type::chunk_alignment()), base(&owner) {}
+    };
+
+    // 页映射只登记内存块，内存块按对齐与堆的簿记数据区分
+    static_assert(base_type::chunk_alignment() > alignof(std::max_align_t),
+                  "max_pooled_alignment must exceed alignof(std::max_align_t)");
+
+    std::pmr::memory_resource* upstream_;
+
+    // 页到所属堆的映射，必须比堆活得久
+    detail::page_map<heap*> owners_;
+
+    // 所有堆，线程退出后堆留待其他线程接管，由 mutex_ 保护
+    std::vector<std::unique_ptr<heap>> heaps_;
+    std::mutex mutex_;
+
+    // 资源的唯一标识，与线程缓存共用线程绑定表
+    const std::uint64_t id_;
+
+    /**
+     * @brief 当前线程绑定的堆，尚未绑定时返回 nullptr
+     */
+    heap* find_local_heap() const noexcept {
+        if (detail::tls_last_cache_owner == id_) {
+            return static_cast<heap*>(detail::tls_last_cache);
+        }
+        return static_cast<heap*>(detail::find_thread_cache(id_));
+    }
+
+    /**
+     * @brief 获取当前线程的堆，首次使用时接管空闲的堆或创建新堆
+     */
+    heap* local_heap() {
+        if (heap* h = find_local_heap()) {
+            return h;
+        }
+        return acquire_heap();
+    }
+
+    heap* acquire_heap();
+
+    /**
+     * @brief 取走堆中某个大小类的全部远程释放对象，拼接回空闲链表，只能由堆的所属线程调用
+     */
+    static void drain(heap* h, std::size_t index) noexcept;
+
+    /**
+     * @brief 线程退出时交还堆
+     */
+    static void release_heap(void* owner, void* h) noexcept;
+
+public:
+    basic_thread_heap_pool_resource();
+    explicit basic_thread_heap_pool_resource(std::pmr::memory_resource* upstream);
+    ~basic_thread_heap_pool_resource() override;
+
+    basic_thread_heap_pool_resource(const basic_thread_heap_pool_resource&) = delete;
+    basic_thread_heap_pool_resource& operator=(const basic_thread_heap_pool_resource&) = delete;
+
+    /**
+     * @brief 上游内存资源
+     */
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return upstream_;
+    }
+
+    /**
+     * @brief 已创建的堆数量，不超过同时使用本资源的线程数
+     */
+    std::size_t heap_count();
+
+    /**
+     * @brief 对象是否属于当前线程的堆；大对象和其他线程的堆中的对象返回 false
+     */
+    bool owned_by_current_thread(const void* p) const noexcept {
+        heap* h = find_local_heap();
+        return h && owners_.get(p) == h;
+    }
+
+    /**
+     * @brief 把当前线程的堆和已无线程使用的堆中完全空闲的内存块归还上游，返回归还的字节数
+     *
+     * 归还前先取走这些堆的远程释放对象。其他线程正在使用的堆不受影响。
+     */
+    std::size_t release();
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+using thread_heap_pool_resource = basic_thread_heap_pool_resource<>;
+
+// basic_thread_heap_pool_resource 实现
+template <pool_options Options>
+basic_thread_heap_pool_resource<Options>::basic_thread_heap_pool_resource()
+    : basic_thread_heap_pool_resource(std::pmr::get_default_resource()) {}
+
+template <pool_options Options>
+basic_thread_heap_pool_resource<Options>::basic_thread_heap_pool_resource(std::pmr::memory_resource* upstream)
+    : upstream_(upstream), id_(detail::register_cache_owner()) {}
+
+template <pool_options Options>
+basic_thread_heap_pool_resource<Options>::~basic_thread_heap_pool_resource() {
+    // 注销后退出的线程不会再访问本资源；再销毁堆，内存块归还时还要清除页映射
+    detail::unregister_cache_owner(id_);
+    heaps_.clear();
+}
+
+template <pool_options Options>
+auto basic_thread_heap_pool_resource<Options>::acquire_heap() -> heap* {
+    heap* h = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& candidate : heaps_) {
+            if (!candidate->in_use) {
+                h = candidate.get();
+                break;
+            }
+        }
+        if (!h) {
+            heaps_.push_back(std::make_unique<heap>(upstream_, &owners_));
+            h = heaps_.back().get();
+        }
+        h->in_use = true;
+    }
+
+    detail::bind_thread_cache({id_, this, h, &basic_thread_heap_pool_resource::release_heap});
+    return h;
+}
+
+template <pool_options Options>
+void basic_thread_heap_pool_resource<Options>::drain(heap* h, std::size_t index) noexcept {
+    // 一次取走整个栈，生产者之后的压入进入新栈，不存在 ABA 问题
+    void* head = h->remote_frees[index].exchange(nullptr, std::memory_order_acquire);
+    if (!head) return;
+
+    void* tail = head;
+    while (detail::next_of(tail)) {
+        tail = detail::next_of(tail);
+    }
+    h->base.deallocate_chain(index, head, tail);
+}
+
+template <pool_options Options>
+void basic_thread_heap_pool_resource<Options>::release_heap(void* owner, void* h) noexcept {
+    auto* self = static_cast<basic_thread_heap_pool_resource*>(owner);
+    auto* local = static_cast<heap*>(h);
+
+    for (std::size_t i = 0; i < base_type::size_class_count(); ++i) {
+        drain(local, i);
+    }
+
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    local->in_use = false;
+}
+
+template <pool_options Options>
+std::size_t basic_thread_heap_pool_resource<Options>::heap_count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return heaps_.size();
+}
+
+template <pool_options Options>
+std::size_t basic_thread_heap_pool_resource<Options>::release() {
+    std::size_t released = 0;
+    heap* local = find_local_heap();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& h : heaps_) {
+        // 持有 mutex_ 时无人使用的堆不会被其他线程接管
+        if (h.get() != local && h->in_use) continue;
+
+        for (std::size_t i = 0; i < base_type::size_class_count(); ++i) {
+            drain(h.get(), i);
+        }
+        released += h->base.release();
+    }
+    return released;
+}
+
+template <pool_options Options>
+void* basic_thread_heap_pool_resource<Options>::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (!base_type::is_pooled(bytes, alignment)) {
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    heap* h = local_heap();
+    std::size_t index = base_type::size_class_index(bytes, alignment);
+
+    // 只有存在远程释放时才执行原子交换，没有跨线程释放时只多一次读取
+    if (h->remote_frees[index].load(std::memory_order_relaxed)) {
+        drain(h, index);
+    }
+    return h->base.allocate_impl(bytes, alignment);
+}
+
+template <pool_options Options>
+void basic_thread_heap_pool_resource<Options>::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    if (!p) return;
+
+    if (!base_type::is_pooled(bytes, alignment)) {
+        upstream_->deallocate(p, bytes, alignment);
+        return;
+    }
+
+    heap* owner = owners_.get(p);
+    if (owner == find_local_heap()) {
+        owner->base.deallocate_impl(p, bytes, alignment);
+        return;
+    }
+
+    // 压入所属堆的远程释放栈
+    std::atomic<void*>& stack = owner->remote_frees[base_type::size_class_index(bytes, alignment)];
+    void* head = stack.load(std::memory_order_relaxed);
+    do {
+        detail::next_of(p) = head;
+    } while (!stack.compare_exchange_weak(head, p, std::memory_order_release, std::memory_order_relaxed));
+}
+
+template <pool_options Options>
+bool basic_thread_heap_pool_resource<Options>::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+extern template class basic_thread_heap_pool_resource<>;
+
+} // namespace sgi_pmr
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sgi_pmr {
+
+/**
+ * @brief 分配轨迹中的操作类型
+ */
+enum class trace_op : std::uint8_t {
+    allocate = 0,
+    deallocate = 1
+};
+
+/**
+ * @brief 分配轨迹中的一条记录，按此布局直接写入文件
+ */
+struct trace_record {
+    std::uint64_t timestamp_ns;     // 距开始记录的纳秒数
+    std::uint64_t id;               // 对象编号，同一对象的分配和释放编号相同
+    std::uint64_t size;             // 请求字节数
+    std::uint16_t thread;           // 线程编号，从 0 开始按首次记录的顺序分配
+    trace_op op;                    // 操作类型
+    std::uint8_t alignment_log2;    // 对齐的以 2 为底的对数
+    std::uint32_t reserved;         // 保留，总为 0
+
+    std::size_t alignment() const noexcept {
+        return std::size_t{1} << alignment_log2;
+    }
+};
+
+static_assert(sizeof(trace_record) == 32, "trace_record is written to disk as is");
+
+/**
+ * @brief 轨迹文件头：魔数、版本和记录大小，之后紧跟若干 trace_record
+ */
+struct trace_file_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t record_size;
+};
+
+inline constexpr char TRACE_MAGIC[8] = {'S', 'G', 'I', 'T', 'R', 'A', 'C', 'E'};
+inline constexpr std::uint32_t TRACE_VERSION = 1;
+
+/**
+ * @brief 记录分配轨迹的内存资源
+ *
+ * 把请求转发给上游资源，同时把每次分配和释放（时间戳、线程、操作、大小、对齐、对象编号）
+ * 以二进制记录追加到文件。把应用使用的资源替换为包装了它的 recording_resource，
+ * 即可得到真实负载的轨迹，再用 benchmarks 下的 sgi_pmr_trace_replay 针对不同资源重放。
+ * 记录在内存中缓冲，缓冲满或析构时写入文件；内部的簿记使用全局堆，不经过上游资源。
+ */
+class recording_resource : public std::pmr::memory_resource {
+public:
+    // 缓冲的记录数，达到后写入文件
+    static constexpr std::size_t BUFFER_RECORDS = 4096;
+
+private:
+    std::pmr::memory_resource* upstream_;
+    std::FILE* file_;
+    std::mutex mutex_;
+
+    std::vector<trace_record> buffer_;
+
+    // 尚未释放的对象地址到编号的映射
+    std::unordered_map<void*, std::uint64_t> live_ids_;
+    std::uint64_t next_id_ = 0;
+    std::uint64_t records_written_ = 0;
+
+    const std::chrono::steady_clock::time_point start_;
+
+    /**
+     * @brief 追加一条记录，调用方持有 mutex_
+     */
+    void append(trace_op op, std::uint64_t id, std::size_t bytes, std::size_t alignment);
+
+    /**
+     * @brief 把缓冲的记录写入文件，调用方持有 mutex_
+     */
+    void write_buffer();
+
+public:
+    /**
+     * @brief 创建记录到 path 的资源，无法打开文件时抛出 std::runtime_error
+     */
+    explicit recording_resource(const std::string& path,
+                                std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    ~recording_resource() override;
+
+    recording_resource(const recording_resource&) = delete;
+    recording_resource& operator=(const recording_resource&) = delete;
+
+    /**
+     * @brief 把缓冲的记录写入文件
+     */
+    void flush();
+
+    /**
+     * @brief 已记录的操作数
+     */
+    std::uint64_t record_count();
+
+    /**
+     * @brief 上游内存资源
+     */
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return upstream_;
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+/**
+ * @brief 读取轨迹文件，格式不符时抛出 std::runtime_error
+ */
+std::vector<trace_record> read_trace(const std::string& path);
+
+} // namespace sgi_pmr
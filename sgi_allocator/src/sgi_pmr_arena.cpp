@@ -0,0 +1,140 @@
+#include "../include/sgi_pmr_arena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace sgi_pmr {
+
+// 块头，位于块起始处
+struct arena_resource::block {
+    block* next;
+    std::size_t bytes;
+};
+
+namespace {
+
+// 块头之后的数据按该值对齐
+constexpr std::size_t HEADER_BYTES = (sizeof(void*) * 2 + alignof(std::max_align_t) - 1)
+                                     & ~(alignof(std::max_align_t) - 1);
+
+char* align_up(char* p, std::size_t align) {
+    auto value = reinterpret_cast<std::uintptr_t>(p);
+    return reinterpret_cast<char*>((value + align - 1) & ~(std::uintptr_t(align) - 1));
+}
+
+} // namespace
+
+arena_resource::arena_resource(std::pmr::memory_resource* upstream, std::size_t block_bytes,
+                               std::size_t max_cached_blocks)
+    : upstream_(upstream),
+      block_bytes_(std::max(block_bytes, HEADER_BYTES * 4)),
+      max_cached_blocks_(max_cached_blocks) {}
+
+arena_resource::~arena_resource() {
+    release();
+}
+
+void arena_resource::free_blocks(block* list) noexcept {
+    while (list) {
+        block* next = list->next;
+        upstream_->deallocate(list, list->bytes, alignof(std::max_align_t));
+        list = next;
+    }
+}
+
+void arena_resource::next_block() {
+    block* b;
+    if (cached_) {
+        b = cached_;
+        cached_ = b->next;
+        --cached_count_;
+    } else {
+        b = static_cast<block*>(upstream_->allocate(block_bytes_, alignof(std::max_align_t)));
+        b->bytes = block_bytes_;
+    }
+
+    b->next = used_;
+    used_ = b;
+    if (!last_used_) {
+        last_used_ = b;
+    }
+    ++used_count_;
+
+    cursor_ = reinterpret_cast<char*>(b) + HEADER_BYTES;
+    end_ = reinterpret_cast<char*>(b) + b->bytes;
+}
+
+void* arena_resource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    char* p = align_up(cursor_, alignment);
+    if (cursor_ && p <= end_ && static_cast<std::size_t>(end_ - p) >= bytes) {
+        cursor_ = p + bytes;
+        return p;
+    }
+
+    // 放不进一个新块的请求单独申请，不浪费当前块的剩余空间
+    std::size_t worst_case = bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+    if (worst_case > block_bytes_ - HEADER_BYTES) {
+        std::size_t total = HEADER_BYTES + worst_case;
+        auto* b = static_cast<block*>(upstream_->allocate(total, alignof(std::max_align_t)));
+        b->bytes = total;
+        b->next = oversized_;
+        oversized_ = b;
+        return align_up(reinterpret_cast<char*>(b) + HEADER_BYTES, alignment);
+    }
+
+    next_block();
+    p = align_up(cursor_, alignment);
+    cursor_ = p + bytes;
+    return p;
+}
+
+void arena_resource::do_deallocate(void* p, std::size_t bytes, std::size_t) {
+    // 只有最近一次分配可以退回，例如容器扩容后立即释放旧缓冲区
+    if (static_cast<char*>(p) + bytes == cursor_) {
+        cursor_ = static_cast<char*>(p);
+    }
+}
+
+bool arena_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void arena_resource::reset() noexcept {
+    free_blocks(oversized_);
+    oversized_ = nullptr;
+
+    // 整段拼接到缓存链表头部，最近使用的块最先被复用
+    if (used_) {
+        last_used_->next = cached_;
+        cached_ = used_;
+        cached_count_ += used_count_;
+    }
+    used_ = last_used_ = nullptr;
+    used_count_ = 0;
+    cursor_ = end_ = nullptr;
+
+    // 超出上限的块归还上游，每个块最多被归还一次，摊还开销为常数
+    if (cached_count_ > max_cached_blocks_) {
+        block* keep = cached_;
+        block* prev = nullptr;
+        for (std::size_t i = 0; i < max_cached_blocks_; ++i) {
+            prev = keep;
+            keep = keep->next;
+        }
+        if (prev) {
+            prev->next = nullptr;
+        } else {
+            cached_ = nullptr;
+        }
+        free_blocks(keep);
+        cached_count_ = max_cached_blocks_;
+    }
+}
+
+void arena_resource::release() noexcept {
+    reset();
+    free_blocks(cached_);
+    cached_ = nullptr;
+    cached_count_ = 0;
+}
+
+} // namespace sgi_pmr
@@ -0,0 +1,250 @@
+#include "../include/sgi_pmr_huge_page.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define SGI_PMR_HAS_MMAP 1
+#else
+#define SGI_PMR_HAS_MMAP 0
+#endif
+
+namespace sgi_pmr {
+
+// 区域头，位于区域起始处，占用一个 BLOCK_ALIGN
+struct huge_page_resource::region {
+    region* next;
+    std::size_t bytes;
+};
+
+// 空闲块头，位于空闲块起始处
+struct huge_page_resource::free_block {
+    free_block* next;
+    std::size_t bytes;
+};
+
+namespace {
+
+std::size_t round_up(std::size_t bytes, std::size_t align) {
+    return (bytes + align - 1) & ~(align - 1);
+}
+
+char* align_up(char* p, std::size_t align) {
+    auto value = reinterpret_cast<std::uintptr_t>(p);
+    return reinterpret_cast<char*>((value + align - 1) & ~(std::uintptr_t(align) - 1));
+}
+
+char* align_down(char* p, std::size_t align) {
+    auto value = reinterpret_cast<std::uintptr_t>(p);
+    return reinterpret_cast<char*>(value & ~(std::uintptr_t(align) - 1));
+}
+
+std::size_t system_page_size() {
+#if SGI_PMR_HAS_MMAP
+    static const std::size_t size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+} // namespace
+
+huge_page_resource::huge_page_resource()
+    : huge_page_resource(DEFAULT_REGION_BYTES) {}
+
+huge_page_resource::huge_page_resource(std::size_t region_bytes)
+    : region_bytes_(round_up(std::max(region_bytes, HUGE_PAGE_SIZE), HUGE_PAGE_SIZE)),
+      release_granularity_(system_page_size()) {}
+
+huge_page_resource::~huge_page_resource() {
+    // 区域头在区域内部，释放区域前先取出下一个区域
+    region* r = regions_;
+    while (r) {
+        region* next = r->next;
+#if SGI_PMR_HAS_MMAP
+        munmap(r, r->bytes);
+#else
+        std::pmr::new_delete_resource()->deallocate(r, r->bytes, HUGE_PAGE_SIZE);
+#endif
+        r = next;
+    }
+}
+
+auto huge_page_resource::last_page_kind() const noexcept -> page_kind {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_kind_;
+}
+
+std::size_t huge_page_resource::reserved_bytes() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reserved_bytes_;
+}
+
+void* huge_page_resource::map(std::size_t bytes, page_kind& kind) {
+#if SGI_PMR_HAS_MMAP
+#ifdef MAP_HUGETLB
+    // 显式大页需要系统预留（vm.nr_hugepages），失败时退回普通映射
+    void* huge = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (huge != MAP_FAILED) {
+        kind = page_kind::hugetlb;
+        return huge;
+    }
+#endif
+
+    // 多映射一个大页再裁掉首尾，使区域按大页对齐，透明大页才能覆盖整个区域
+    std::size_t span = bytes + HUGE_PAGE_SIZE;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    char* begin = static_cast<char*>(raw);
+    char* base = align_up(begin, HUGE_PAGE_SIZE);
+    char* end = begin + span;
+    if (base != begin) {
+        munmap(begin, base - begin);
+    }
+    if (base + bytes != end) {
+        munmap(base + bytes, end - (base + bytes));
+    }
+
+    kind = page_kind::normal;
+#ifdef MADV_HUGEPAGE
+    if (madvise(base, bytes, MADV_HUGEPAGE) == 0) {
+        kind = page_kind::transparent;
+    }
+#endif
+    return base;
+#else
+    kind = page_kind::normal;
+    return std::pmr::new_delete_resource()->allocate(bytes, HUGE_PAGE_SIZE);
+#endif
+}
+
+void huge_page_resource::add_region(std::size_t min_bytes) {
+    // 超过区域大小的请求单独占用一个足够大的区域
+    std::size_t bytes = std::max(region_bytes_, round_up(min_bytes + BLOCK_ALIGN, HUGE_PAGE_SIZE));
+    page_kind kind;
+    char* base = static_cast<char*>(map(bytes, kind));
+
+    regions_ = ::new (base) region{regions_, bytes};
+    reserved_bytes_ += bytes;
+    last_kind_ = kind;
+    if (kind == page_kind::hugetlb) {
+        release_granularity_ = HUGE_PAGE_SIZE;
+    }
+
+    // 旧区域剩余的部分挂入空闲块链表
+    if (cursor_ != region_end_) {
+        insert_free_block(cursor_, region_end_ - cursor_);
+    }
+    cursor_ = base + BLOCK_ALIGN;
+    region_end_ = base + bytes;
+}
+
+void* huge_page_resource::take_free_block(std::size_t bytes, std::size_t alignment) {
+    for (free_block** link = &free_blocks_; *link; link = &(*link)->next) {
+        free_block* b = *link;
+        char* begin = reinterpret_cast<char*>(b);
+        char* end = begin + b->bytes;
+        char* p = align_up(begin, alignment);
+        if (p >= end || static_cast<std::size_t>(end - p) < bytes) continue;
+
+        // 原地拆分：前部对齐空隙保留在原节点，尾部剩余部分成为新节点
+        free_block* next = b->next;
+        char* rest = p + bytes;
+        if (rest != end) {
+            next = ::new (rest) free_block{next, static_cast<std::size_t>(end - rest)};
+        }
+        if (p != begin) {
+            b->bytes = p - begin;
+            b->next = next;
+        } else {
+            *link = next;
+        }
+        return p;
+    }
+    return nullptr;
+}
+
+void huge_page_resource::insert_free_block(char* p, std::size_t bytes) {
+    free_block* prev = nullptr;
+    free_block* next = free_blocks_;
+    while (next && reinterpret_cast<char*>(next) < p) {
+        prev = next;
+        next = next->next;
+    }
+
+    // 与前后相邻的空闲块合并
+    free_block* block;
+    if (prev && reinterpret_cast<char*>(prev) + prev->bytes == p) {
+        block = prev;
+        block->bytes += bytes;
+    } else {
+        block = ::new (p) free_block{next, bytes};
+        if (prev) {
+            prev->next = block;
+        } else {
+            free_blocks_ = block;
+        }
+    }
+    if (next && reinterpret_cast<char*>(block) + block->bytes == reinterpret_cast<char*>(next)) {
+        block->bytes += next->bytes;
+        block->next = next->next;
+    }
+
+#if SGI_PMR_HAS_MMAP && defined(MADV_DONTNEED)
+    // 只归还新释放区间中不含块头的完整页
+    char* block_begin = reinterpret_cast<char*>(block);
+    char* release_begin = align_up(std::max(p, block_begin + sizeof(free_block)), release_granularity_);
+    char* release_end = align_down(p + bytes, release_granularity_);
+    if (release_begin < release_end) {
+        madvise(release_begin, release_end - release_begin, MADV_DONTNEED);
+    }
+#endif
+}
+
+void* huge_page_resource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    bytes = round_up(std::max<std::size_t>(bytes, 1), BLOCK_ALIGN);
+    alignment = std::max(alignment, BLOCK_ALIGN);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (void* p = take_free_block(bytes, alignment)) {
+        return p;
+    }
+
+    char* p = cursor_ ? align_up(cursor_, alignment) : nullptr;
+    if (!p || p > region_end_ || static_cast<std::size_t>(region_end_ - p) < bytes) {
+        add_region(bytes + alignment - BLOCK_ALIGN);
+        p = align_up(cursor_, alignment);
+    }
+
+    // 对齐产生的空隙同样可以复用
+    if (p != cursor_) {
+        insert_free_block(cursor_, p - cursor_);
+    }
+    cursor_ = p + bytes;
+    return p;
+}
+
+void huge_page_resource::do_deallocate(void* p, std::size_t bytes, std::size_t) {
+    if (!p) return;
+
+    bytes = round_up(std::max<std::size_t>(bytes, 1), BLOCK_ALIGN);
+    std::lock_guard<std::mutex> lock(mutex_);
+    insert_free_block(static_cast<char*>(p), bytes);
+}
+
+bool huge_page_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+} // namespace sgi_pmr
@@ -0,0 +1,8 @@
+#include "../include/sgi_pmr_lockfree.hpp"
+
+namespace sgi_pmr {
+
+// 默认配置的显式实例化
+template class basic_lockfree_pool_resource<>;
+
+} // namespace sgi_pmr
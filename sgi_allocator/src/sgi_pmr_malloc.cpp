@@ -0,0 +1,338 @@
+// 用 SGI 池替换全局 malloc 系列函数和 operator new/delete
+//
+// 编译为共享库时通过 LD_PRELOAD 注入未修改的程序；编译为目标文件时直接链接进可执行文件。
+// 所有请求由一个线程安全、按大小类划分内存块的池资源处理，内存块来自 mmap，
+// 释放时通过页映射查出大小类，不需要调用方提供大小。
+
+#include "../include/sgi_pmr_allocator.hpp"
+#include "../include/sgi_pmr_page_map.hpp"
+#include "../include/sgi_pmr_huge_page.hpp"
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#ifdef __GLIBC__
+#include <dlfcn.h>
+#include <pthread.h>
+
+// glibc 自身的实现，用于处理不属于池的指针和池内部重入的请求
+extern "C" void* __libc_memalign(std::size_t, std::size_t);
+extern "C" void __libc_free(void*);
+extern "C" void* __libc_realloc(void*, std::size_t);
+#endif
+
+namespace {
+
+// 小于 32KB 的请求按几何间隔的大小类池化，按 16 字节对齐以满足 max_align_t
+constexpr sgi_pmr::pool_options malloc_options{
+    .alignment = 16,
+    .max_bytes = std::size_t{32} << 10,
+    .spacing = sgi_pmr::size_class_spacing::geometric,
+    .refill_batch = 8,
+    .min_refill_batch = 1,
+    .max_refill_batch = 128,
+    .size_class_spans = true,
+};
+
+using pool_type = sgi_pmr::basic_synchronized_pool_resource<malloc_options>;
+
+constexpr std::size_t MALLOC_ALIGN = malloc_options.alignment;
+
+/**
+ * @brief 全局池，首次使用时在静态存储中构造，永不析构
+ *
+ * 其他静态对象析构时仍可能释放内存，因此池和上游都不能随程序退出而销毁。
+ * 上游直接 mmap，池内部的簿记也来自上游，不会递归进入 malloc。
+ */
+pool_type& pool() {
+    alignas(sgi_pmr::huge_page_resource) static unsigned char upstream_storage[sizeof(sgi_pmr::huge_page_resource)];
+    alignas(pool_type) static unsigned char pool_storage[sizeof(pool_type)];
+    static pool_type* instance = ::new (pool_storage) pool_type(::new (upstream_storage) sgi_pmr::huge_page_resource());
+    return *instance;
+}
+
+// 当前线程正在池内分配。上游失败时在持有池锁的情况下抛出 std::bad_alloc，
+// 构造异常对象又会调用 malloc，此时不能再进入池
+thread_local bool in_pool = false;
+
+void* allocate(std::size_t bytes, std::size_t alignment) noexcept {
+    if (in_pool) {
+#ifdef __GLIBC__
+        return __libc_memalign(alignment, bytes ? bytes : 1);
+#else
+        return nullptr;
+#endif
+    }
+
+    in_pool = true;
+    void* p;
+    try {
+        p = pool().allocate(bytes ? bytes : 1, alignment);
+    } catch (...) {
+        errno = ENOMEM;
+        p = nullptr;
+    }
+    in_pool = false;
+    return p;
+}
+
+void deallocate(void* p) noexcept {
+    if (!pool().deallocate_unsized(p)) {
+        // 不属于池的指针（例如注入前由动态链接器分配）交给 glibc
+#ifdef __GLIBC__
+        __libc_free(p);
+#endif
+    }
+}
+
+#ifdef __GLIBC__
+/**
+ * @brief glibc 的 malloc_usable_size，用于不属于池的指针；glibc 没有导出 __libc_ 版本，通过 RTLD_NEXT 查找
+ */
+std::size_t libc_usable_size(void* p) noexcept {
+    using usable_size_fn = std::size_t (*)(void*);
+    static const usable_size_fn next =
+        reinterpret_cast<usable_size_fn>(dlsym(RTLD_NEXT, "malloc_usable_size"));
+    return next ? next(p) : 0;
+}
+
+// fork 前持有池锁，使子进程中的池处于一致状态；
+// 否则子进程继承另一个线程持有的锁，第一次 malloc 就会死锁
+void lock_pool() {
+    pool().lock();
+}
+
+void unlock_pool() {
+    pool().unlock();
+}
+
+// 加载时注册；pthread_atfork 内部的分配照常进入已构造的池
+[[maybe_unused]] const int fork_handlers = pthread_atfork(lock_pool, unlock_pool, unlock_pool);
+#endif
+
+bool is_power_of_two(std::size_t alignment) noexcept {
+    return alignment != 0 && (alignment & (alignment - 1)) == 0;
+}
+
+/**
+ * @brief operator new 的语义：失败时调用 new_handler 重试，没有 new_handler 时抛出 std::bad_alloc
+ */
+void* allocate_or_throw(std::size_t bytes, std::size_t alignment) {
+    for (;;) {
+        if (void* p = allocate(bytes, alignment)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* allocate_nothrow(std::size_t bytes, std::size_t alignment) noexcept {
+    try {
+        return allocate_or_throw(bytes, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(std::size_t bytes) {
+    return allocate(bytes, MALLOC_ALIGN);
+}
+
+void free(void* p) {
+    if (p) {
+        deallocate(p);
+    }
+}
+
+void* calloc(std::size_t count, std::size_t size) {
+    std::size_t bytes;
+    if (__builtin_mul_overflow(count, size, &bytes)) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+    // 池中的对象可能被复用过，必须清零
+    void* p = allocate(bytes, MALLOC_ALIGN);
+    if (p) {
+        std::memset(p, 0, bytes);
+    }
+    return p;
+}
+
+void* realloc(void* p, std::size_t bytes) {
+    if (!p) {
+        return allocate(bytes, MALLOC_ALIGN);
+    }
+    if (bytes == 0) {
+        deallocate(p);
+        return nullptr;
+    }
+
+    std::size_t old_size = pool().allocation_size(p);
+#ifdef __GLIBC__
+    if (old_size == 0) {
+        return __libc_realloc(p, bytes);
+    }
+#endif
+
+    // 新大小仍落在原对象内且不会浪费一半以上时原地返回
+    if (bytes <= old_size && bytes > old_size / 2) {
+        return p;
+    }
+    void* q = allocate(bytes, MALLOC_ALIGN);
+    if (q) {
+        std::memcpy(q, p, bytes < old_size ? bytes : old_size);
+        deallocate(p);
+    }
+    return q;
+}
+
+int posix_memalign(void** out, std::size_t alignment, std::size_t bytes) {
+    // POSIX 要求对齐是 sizeof(void*) 的 2 的幂倍
+    if (alignment < sizeof(void*) || !is_power_of_two(alignment)) {
+        return EINVAL;
+    }
+    void* p = allocate(bytes, alignment < MALLOC_ALIGN ? MALLOC_ALIGN : alignment);
+    if (!p) {
+        return ENOMEM;
+    }
+    *out = p;
+    return 0;
+}
+
+// 与 glibc 相同，接受任意 2 的幂对齐，包括小于指针大小的对齐
+void* aligned_alloc(std::size_t alignment, std::size_t bytes) {
+    if (!is_power_of_two(alignment)) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    return allocate(bytes, alignment < MALLOC_ALIGN ? MALLOC_ALIGN : alignment);
+}
+
+// 与 glibc 相同，对齐不是 2 的幂时向上取整，不会因对齐失败
+void* memalign(std::size_t alignment, std::size_t bytes) {
+    if (alignment <= MALLOC_ALIGN) {
+        return allocate(bytes, MALLOC_ALIGN);
+    }
+    if (alignment > (SIZE_MAX >> 1) + 1) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+    return allocate(bytes, std::bit_ceil(alignment));
+}
+
+void* valloc(std::size_t bytes) {
+    return allocate(bytes, sgi_pmr::detail::PAGE_SIZE);
+}
+
+void* pvalloc(std::size_t bytes) {
+    std::size_t rounded = (bytes + sgi_pmr::detail::PAGE_SIZE - 1) & ~(sgi_pmr::detail::PAGE_SIZE - 1);
+    return allocate(rounded, sgi_pmr::detail::PAGE_SIZE);
+}
+
+std::size_t malloc_usable_size(void* p) {
+    if (!p) {
+        return 0;
+    }
+    std::size_t size = pool().allocation_size(p);
+#ifdef __GLIBC__
+    if (size == 0) {
+        return libc_usable_size(p);
+    }
+#endif
+    return size;
+}
+
+} // extern "C"
+
+// operator new/delete：普通、nothrow、对齐和带大小的各个版本
+void* operator new(std::size_t bytes) {
+    return allocate_or_throw(bytes, MALLOC_ALIGN);
+}
+
+void* operator new[](std::size_t bytes) {
+    return allocate_or_throw(bytes, MALLOC_ALIGN);
+}
+
+void* operator new(std::size_t bytes, const std::nothrow_t&) noexcept {
+    return allocate_nothrow(bytes, MALLOC_ALIGN);
+}
+
+void* operator new[](std::size_t bytes, const std::nothrow_t&) noexcept {
+    return allocate_nothrow(bytes, MALLOC_ALIGN);
+}
+
+void* operator new(std::size_t bytes, std::align_val_t alignment) {
+    return allocate_or_throw(bytes, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t bytes, std::align_val_t alignment) {
+    return allocate_or_throw(bytes, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t bytes, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate_nothrow(bytes, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t bytes, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate_nothrow(bytes, static_cast<std::size_t>(alignment));
+}
+
+// 页映射记录了每个对象的大小类，带大小和对齐的版本同样走不带大小的释放
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    free(p);
+}
@@ -0,0 +1,186 @@
+#include "../include/sgi_pmr_profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fstream>
+#include <string>
+
+namespace sgi_pmr {
+
+namespace {
+
+// 帧的可读名称：优先使用反修饰后的符号名，其次是模块名加地址，都没有时为十六进制地址
+std::string frame_name(void* frame) {
+    char address[2 + sizeof(void*) * 2 + 1];
+    std::snprintf(address, sizeof(address), "%p", frame);
+
+    Dl_info info{};
+    if (!dladdr(frame, &info)) {
+        return address;
+    }
+    if (info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+        std::free(demangled);
+        return name;
+    }
+    if (info.dli_fname) {
+        const char* base = std::strrchr(info.dli_fname, '/');
+        return std::string(base ? base + 1 : info.dli_fname) + "+" + address;
+    }
+    return address;
+}
+
+} // namespace
+
+heap_profiler::heap_profiler() {
+    // backtrace 首次调用会加载 libgcc 并分配内存，提前触发，避免发生在分配路径中
+    void* frames[1];
+    backtrace(frames, 1);
+}
+
+heap_profiler& heap_profiler::global() {
+    // 有意泄漏：静态对象析构后仍可能有池资源释放对象
+    static heap_profiler* profiler = new heap_profiler();
+    return *profiler;
+}
+
+std::size_t heap_profiler::next_sample_interval(std::uint64_t& state, std::size_t mean) noexcept {
+    // xorshift64，取高 53 位作为 (0, 1] 上的均匀分布
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    double u = (static_cast<double>(state >> 11) + 1.0) * 0x1.0p-53;
+    return static_cast<std::size_t>(-std::log(u) * static_cast<double>(mean)) + 1;
+}
+
+void heap_profiler::record_allocation(const void* p, std::size_t bytes, std::size_t interval) {
+    // 跳过本函数自身的帧
+    void* buffer[MAX_FRAMES + 1];
+    int depth = backtrace(buffer, static_cast<int>(MAX_FRAMES + 1));
+    std::vector<void*> frames(buffer + std::min(depth, 1), buffer + depth);
+
+    // 指数间隔下 bytes 字节的分配被抽中的概率为 1 - exp(-bytes / interval)
+    double probability = 1.0 - std::exp(-static_cast<double>(bytes) / static_cast<double>(interval));
+    double weight = static_cast<double>(bytes) / probability;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 池析构时仍未释放的对象没有注销，地址被重新使用时先移除旧记录
+    erase_live(p);
+
+    auto [it, inserted] = stacks_.try_emplace(std::move(frames));
+    stack_sample& stack = it->second;
+    if (inserted) {
+        stack.frames = it->first;
+    }
+    ++stack.live_count;
+    stack.live_bytes += bytes;
+    ++stack.total_count;
+    stack.total_bytes += bytes;
+    stack.live_estimate += weight;
+
+    live_.emplace(p, live_object{bytes, weight, &stack});
+    filter_[filter_slot(p)].fetch_add(1, std::memory_order_relaxed);
+    interval_ = interval;
+}
+
+bool heap_profiler::erase_live(const void* p) noexcept {
+    auto it = live_.find(p);
+    if (it == live_.end()) return false;
+
+    stack_sample& stack = *it->second.stack;
+    --stack.live_count;
+    stack.live_bytes -= it->second.bytes;
+    stack.live_estimate = stack.live_count ? stack.live_estimate - it->second.weight : 0;
+    live_.erase(it);
+    filter_[filter_slot(p)].fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+void heap_profiler::erase_sampled(const void* p) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    erase_live(p);
+}
+
+std::size_t heap_profiler::live_samples() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return live_.size();
+}
+
+std::vector<heap_profiler::stack_sample> heap_profiler::snapshot() const {
+    std::vector<stack_sample> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.reserve(stacks_.size());
+        for (const auto& [frames, stack] : stacks_) {
+            result.push_back(stack);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const stack_sample& a, const stack_sample& b) {
+        return a.live_estimate > b.live_estimate;
+    });
+    return result;
+}
+
+void heap_profiler::write_folded(std::ostream& out) const {
+    for (const stack_sample& stack : snapshot()) {
+        if (stack.live_count == 0) continue;
+
+        // 折叠栈从最外层的帧开始
+        for (std::size_t i = stack.frames.size(); i-- > 0;) {
+            out << frame_name(stack.frames[i]);
+            if (i != 0) out << ';';
+        }
+        out << ' ' << static_cast<std::uint64_t>(std::llround(stack.live_estimate)) << '\n';
+    }
+}
+
+void heap_profiler::write_pprof(std::ostream& out) const {
+    std::vector<stack_sample> stacks = snapshot();
+    std::size_t interval;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        interval = interval_;
+    }
+
+    // 与 gperftools 一样输出未放大的采样值，pprof 按 heap_v2 的采样间隔自行换算
+    std::uint64_t live_count = 0, live_bytes = 0, total_count = 0, total_bytes = 0;
+    for (const stack_sample& stack : stacks) {
+        live_count += stack.live_count;
+        live_bytes += stack.live_bytes;
+        total_count += stack.total_count;
+        total_bytes += stack.total_bytes;
+    }
+
+    out << "heap profile: " << live_count << ": " << live_bytes << " [" << total_count << ": " << total_bytes
+        << "] @ heap_v2/" << interval << '\n';
+    for (const stack_sample& stack : stacks) {
+        out << stack.live_count << ": " << stack.live_bytes << " [" << stack.total_count << ": "
+            << stack.total_bytes << "] @";
+        for (void* frame : stack.frames) {
+            out << ' ' << frame;
+        }
+        out << '\n';
+    }
+
+    out << "\nMAPPED_LIBRARIES:\n";
+    std::ifstream maps("/proc/self/maps");
+    out << maps.rdbuf();
+}
+
+void heap_profiler::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [p, object] : live_) {
+        filter_[filter_slot(p)].fetch_sub(1, std::memory_order_relaxed);
+    }
+    live_.clear();
+    stacks_.clear();
+}
+
+} // namespace sgi_pmr
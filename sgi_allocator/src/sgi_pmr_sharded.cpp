@@ -0,0 +1,39 @@
+#include "../include/sgi_pmr_sharded.hpp"
+#include <functional>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace sgi_pmr {
+
+namespace detail {
+
+namespace {
+
+// 线程标识的哈希只计算一次
+std::size_t thread_hash() noexcept {
+    thread_local const std::size_t hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return hash;
+}
+
+} // namespace
+
+std::size_t current_shard_hint([[maybe_unused]] shard_selection selection) noexcept {
+#if defined(__linux__)
+    if (selection == shard_selection::cpu) {
+        int cpu = sched_getcpu();
+        if (cpu >= 0) {
+            return static_cast<std::size_t>(cpu);
+        }
+    }
+#endif
+    return thread_hash();
+}
+
+} // namespace detail
+
+// 默认配置的显式实例化
+template class basic_sharded_pool_resource<>;
+
+} // namespace sgi_pmr
@@ -0,0 +1,10 @@
+#include "../include/sgi_pmr_slab.hpp"
+
+namespace sgi_pmr {
+
+// 默认配置的显式实例化
+template class basic_slab_pool_base<>;
+template class basic_synchronized_slab_pool_resource<>;
+template class basic_unsynchronized_slab_pool_resource<>;
+
+} // namespace sgi_pmr
@@ -0,0 +1,89 @@
+#include "../include/sgi_pmr_thread_cache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <unordered_set>
+
+namespace sgi_pmr {
+
+namespace detail {
+
+namespace {
+
+// 全局注册表，保护资源存活集合以及线程退出时的归还过程。
+// 有意不析构，避免与线程局部对象的析构顺序产生依赖。
+std::mutex& registry_mutex() {
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+std::unordered_set<std::uint64_t>& live_owners() {
+    static auto* ids = new std::unordered_set<std::uint64_t>;
+    return *ids;
+}
+
+std::atomic<std::uint64_t> next_owner_id{1};
+
+// 线程退出时把所有仍然存活的资源的缓存归还
+struct thread_bindings {
+    std::vector<thread_cache_binding> bindings;
+
+    ~thread_bindings() {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (const thread_cache_binding& b : bindings) {
+            if (live_owners().count(b.owner_id)) {
+                b.release(b.owner, b.cache);
+            }
+        }
+    }
+};
+
+thread_local thread_bindings tls_bindings;
+
+} // namespace
+
+std::uint64_t register_cache_owner() {
+    std::uint64_t id = next_owner_id.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    live_owners().insert(id);
+    return id;
+}
+
+void unregister_cache_owner(std::uint64_t id) noexcept {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    live_owners().erase(id);
+}
+
+void* find_thread_cache(std::uint64_t owner_id) noexcept {
+    for (const thread_cache_binding& b : tls_bindings.bindings) {
+        if (b.owner_id == owner_id) {
+            tls_last_cache_owner = owner_id;
+            tls_last_cache = b.cache;
+            return b.cache;
+        }
+    }
+    return nullptr;
+}
+
+void bind_thread_cache(const thread_cache_binding& binding) {
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        // 顺便清理已销毁资源留下的绑定
+        auto& bindings = tls_bindings.bindings;
+        bindings.erase(std::remove_if(bindings.begin(), bindings.end(),
+                                      [](const thread_cache_binding& b) {
+                                          return !live_owners().count(b.owner_id);
+                                      }),
+                       bindings.end());
+        bindings.push_back(binding);
+    }
+
+    tls_last_cache_owner = binding.owner_id;
+    tls_last_cache = binding.cache;
+}
+
+} // namespace detail
+
+// 默认配置的显式实例化
+template class basic_thread_cached_pool_resource<>;
+
+} // namespace sgi_pmr
@@ -0,0 +1,8 @@
+#include "../include/sgi_pmr_thread_heap.hpp"
+
+namespace sgi_pmr {
+
+// 默认配置的显式实例化
+template class basic_thread_heap_pool_resource<>;
+
+} // namespace sgi_pmr
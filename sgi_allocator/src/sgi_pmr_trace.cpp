@@ -0,0 +1,130 @@
+#include "../include/sgi_pmr_trace.hpp"
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace sgi_pmr {
+
+namespace {
+
+std::atomic<std::uint16_t> next_thread_index{0};
+
+// 线程编号在首次记录时分配，所有 recording_resource 共用
+std::uint16_t current_thread_index() {
+    thread_local const std::uint16_t index = next_thread_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} // namespace
+
+recording_resource::recording_resource(const std::string& path, std::pmr::memory_resource* upstream)
+    : upstream_(upstream), file_(std::fopen(path.c_str(), "wb")), start_(std::chrono::steady_clock::now()) {
+    if (!file_) {
+        throw std::runtime_error("cannot open trace file: " + path);
+    }
+
+    trace_file_header header{};
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.record_size = sizeof(trace_record);
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+        std::fclose(file_);
+        throw std::runtime_error("cannot write trace file: " + path);
+    }
+    buffer_.reserve(BUFFER_RECORDS);
+}
+
+recording_resource::~recording_resource() {
+    write_buffer();
+    std::fclose(file_);
+}
+
+void recording_resource::append(trace_op op, std::uint64_t id, std::size_t bytes, std::size_t alignment) {
+    trace_record r{};
+    r.timestamp_ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+    r.id = id;
+    r.size = bytes;
+    r.thread = current_thread_index();
+    r.op = op;
+    r.alignment_log2 = static_cast<std::uint8_t>(std::countr_zero(alignment));
+
+    buffer_.push_back(r);
+    ++records_written_;
+    if (buffer_.size() >= BUFFER_RECORDS) {
+        write_buffer();
+    }
+}
+
+void recording_resource::write_buffer() {
+    if (buffer_.empty()) return;
+
+    // 写入失败时丢弃这批记录，不影响被记录的分配本身
+    std::fwrite(buffer_.data(), sizeof(trace_record), buffer_.size(), file_);
+    buffer_.clear();
+}
+
+void recording_resource::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_buffer();
+    std::fflush(file_);
+}
+
+std::uint64_t recording_resource::record_count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_written_;
+}
+
+void* recording_resource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    void* p = upstream_->allocate(bytes, alignment);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uint64_t id = next_id_++;
+    live_ids_[p] = id;
+    append(trace_op::allocate, id, bytes, alignment);
+    return p;
+}
+
+void recording_resource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = live_ids_.find(p);
+        // 不是经由本资源分配的对象只转发，不记录
+        if (it != live_ids_.end()) {
+            append(trace_op::deallocate, it->second, bytes, alignment);
+            live_ids_.erase(it);
+        }
+    }
+    upstream_->deallocate(p, bytes, alignment);
+}
+
+bool recording_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+std::vector<trace_record> read_trace(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        throw std::runtime_error("cannot open trace file: " + path);
+    }
+
+    trace_file_header header{};
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TRACE_VERSION || header.record_size != sizeof(trace_record)) {
+        std::fclose(file);
+        throw std::runtime_error("not a trace file: " + path);
+    }
+
+    std::vector<trace_record> records;
+    trace_record buffer[1024];
+    std::size_t n;
+    while ((n = std::fread(buffer, sizeof(trace_record), 1024, file)) > 0) {
+        records.insert(records.end(), buffer, buffer + n);
+    }
+    std::fclose(file);
+    return records;
+}
+
+} // namespace sgi_pmr
@@ -1,10 +1,17 @@
 #include <gtest/gtest.h>
 #include "../include/sgi_pmr_allocator.hpp"
+#include "../include/sgi_pmr_page_map.hpp"
 #include <vector>
 #include <memory>
 #include <thread>
 #include <atomic>
 #include <random>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <list>
+#include <map>
 
 using namespace sgi_pmr;
 
@@ -386,7 +393,1117 @@ TEST(SGIUnsynchronizedPoolResourceTest, RandomAllocationPattern) {
     }
 }
 
+TEST(SGIPoolResourceBaseTest, RefillCarvesFromMemoryPool) {
+    sgi_pool_resource_base pool;
+
+    // 第一次 refill 申请的内存块足以满足后续多次 refill
+    void* first = pool.allocate_impl(8, 8);
+    EXPECT_NE(first, nullptr);
+    EXPECT_EQ(pool.chunk_count(), 1);
+
+    std::vector<void*> pointers;
+    for (int i = 0; i < 20; ++i) {
+        pointers.push_back(pool.allocate_impl(8, 8));
+    }
+    EXPECT_EQ(pool.chunk_count(), 1);
+
+    // 对象在内存池中连续切分，不会重叠
+    std::sort(pointers.begin(), pointers.end());
+    for (std::size_t i = 1; i < pointers.size(); ++i) {
+        EXPECT_GE(static_cast<char*>(pointers[i]) - static_cast<char*>(pointers[i - 1]), 8);
+    }
+}
+
+TEST(SGIPoolResourceBaseTest, GeometricChunkGrowth) {
+    sgi_pool_resource_base pool;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> size_dist(8, 128);
+
+    // 内存块大小随已申请总量增长，块的数量远少于 refill 次数
+    std::vector<std::pair<void*, std::size_t>> allocations;
+    for (int i = 0; i < 100000; ++i) {
+        std::size_t size = size_dist(rng);
+        void* ptr = pool.allocate_impl(size, 8);
+        std::memset(ptr, 0xab, size);
+        allocations.emplace_back(ptr, size);
+    }
+    EXPECT_LT(pool.chunk_count(), 100);
+
+    for (const auto& alloc : allocations) {
+        pool.deallocate_impl(alloc.first, alloc.second, 8);
+    }
+}
+
+TEST(SGIPoolResourceBaseTest, LeftoverGoesToSmallerFreeList) {
+    sgi_pool_resource_base pool;
+
+    // 第一个 8 字节对象申请 320 字节的内存块，切出 20 个对象后内存池剩 160 字节
+    void* small = pool.allocate_impl(8, 8);
+
+    // 内存池只够一个 128 字节对象，切出后剩 32 字节零头
+    void* first = pool.allocate_impl(128, 8);
+    std::size_t chunks_before = pool.chunk_count();
+
+    // 下一个 128 字节对象需要新的内存块，零头挂入 32 字节的空闲链表而不是丢弃
+    void* second = pool.allocate_impl(128, 8);
+    EXPECT_EQ(pool.chunk_count(), chunks_before + 1);
+    void* tail = pool.allocate_impl(32, 8);
+    EXPECT_EQ(tail, static_cast<char*>(first) + 128);
+
+    pool.deallocate_impl(tail, 32, 8);
+    pool.deallocate_impl(second, 128, 8);
+    pool.deallocate_impl(first, 128, 8);
+    pool.deallocate_impl(small, 8, 8);
+}
+
+TEST(SGIPoolOptionsTest, LinearSizeClassTable) {
+    using table = detail::size_class_table<pool_options{}>;
+
+    // 默认配置：16 个线性大小类 8, 16, ..., 128
+    EXPECT_EQ(table::count, 16);
+    for (std::size_t i = 0; i < table::count; ++i) {
+        EXPECT_EQ(table::sizes[i], (i + 1) * 8);
+    }
+
+    EXPECT_EQ(sgi_pool_resource_base::size_class_index(1), 0);
+    EXPECT_EQ(sgi_pool_resource_base::size_class_index(8), 0);
+    EXPECT_EQ(sgi_pool_resource_base::size_class_index(9), 1);
+    EXPECT_EQ(sgi_pool_resource_base::size_class_index(128), 15);
+}
+
+TEST(SGIPoolOptionsTest, GeometricSizeClassTable) {
+    constexpr pool_options options{.max_bytes = 512, .spacing = size_class_spacing::geometric};
+    using table = detail::size_class_table<options>;
+    using base = basic_sgi_pool_resource_base<options>;
+
+    // 每次翻倍划分为 4 个大小类
+    constexpr std::size_t expected[] = {8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128,
+                                        160, 192, 224, 256, 320, 384, 448, 512};
+    ASSERT_EQ(table::count, std::size(expected));
+    for (std::size_t i = 0; i < table::count; ++i) {
+        EXPECT_EQ(table::sizes[i], expected[i]);
+    }
+
+    // 每个大小都映射到不小于它的最小大小类
+    for (std::size_t bytes = 1; bytes <= 512; ++bytes) {
+        std::size_t index = base::size_class_index(bytes);
+        EXPECT_GE(base::size_class_bytes(index), bytes);
+        if (index > 0) {
+            EXPECT_LT(base::size_class_bytes(index - 1), bytes);
+        }
+    }
+}
+
+TEST(SGIPoolOptionsTest, LargerMaxBytesArePooled) {
+    constexpr pool_options options{.max_bytes = 512, .spacing = size_class_spacing::geometric};
+    basic_unsynchronized_pool_resource<options> mr;
+
+    // 160~512 字节的对象进入空闲链表，释放后被重用
+    void* ptr1 = mr.allocate(200, 8);
+    mr.deallocate(ptr1, 200, 8);
+    void* ptr2 = mr.allocate(220, 8);
+    EXPECT_EQ(ptr1, ptr2);
+    mr.deallocate(ptr2, 220, 8);
+
+    EXPECT_TRUE(basic_sgi_pool_resource_base<options>::is_pooled(512, 8));
+    EXPECT_FALSE(basic_sgi_pool_resource_base<options>::is_pooled(513, 8));
+}
+
+TEST(SGIPoolOptionsTest, CustomAlignmentAndBatch) {
+    constexpr pool_options options{.alignment = 32, .max_bytes = 256, .refill_batch = 4};
+    basic_sgi_pool_resource_base<options> pool;
+
+    std::vector<void*> pointers;
+    for (int i = 0; i < 64; ++i) {
+        void* ptr = pool.allocate_impl(40, 32);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 32, 0);
+        pointers.push_back(ptr);
+    }
+
+    for (void* ptr : pointers) {
+        pool.deallocate_impl(ptr, 40, 32);
+    }
+}
+
+TEST(SGIPoolOptionsTest, SynchronizedResourceWithOptions) {
+    constexpr pool_options options{.max_bytes = 1024, .spacing = size_class_spacing::geometric};
+    basic_synchronized_pool_resource<options> mr;
+    std::pmr::vector<std::pmr::string> strings(&mr);
+
+    for (int i = 0; i < 100; ++i) {
+        strings.emplace_back(std::string(300, 'a' + i % 26));
+    }
+
+    EXPECT_EQ(strings.size(), 100);
+    EXPECT_EQ(strings[1][0], 'b');
+}
+
+TEST(SGIPoolResourceBaseTest, OverAlignedSizeClasses) {
+    sgi_pool_resource_base pool;
+
+    // 16/32/64 字节对齐的请求由各自对齐层的空闲链表处理
+    for (std::size_t alignment : {16, 32, 64}) {
+        std::vector<std::pair<void*, std::size_t>> allocations;
+        for (std::size_t size = 8; size <= 128; size += 8) {
+            if (!sgi_pool_resource_base::is_pooled(size, alignment)) continue;
+            for (int i = 0; i < 50; ++i) {
+                void* ptr = pool.allocate_impl(size, alignment);
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0)
+                    << "size " << size << " alignment " << alignment;
+                std::memset(ptr, 0xcd, size);
+                allocations.emplace_back(ptr, size);
+            }
+        }
+
+        // 释放后再次分配应重用同一对象
+        void* last = allocations.back().first;
+        std::size_t last_size = allocations.back().second;
+        for (const auto& alloc : allocations) {
+            pool.deallocate_impl(alloc.first, alloc.second, alignment);
+        }
+        EXPECT_EQ(pool.allocate_impl(last_size, alignment), last);
+        pool.deallocate_impl(last, last_size, alignment);
+    }
+
+    // 所有对齐层共享同一个内存池，内存块数量远少于 refill 次数（约 90 次）
+    EXPECT_LT(pool.chunk_count(), 45);
+}
+
+TEST(SGIPoolResourceBaseTest, OverAlignedBeyondPoolLimit) {
+    sgi_pool_resource_base pool;
+
+    // 超过最大池化对齐或取整后超过 MAX_BYTES 的请求走大对象路径
+    EXPECT_FALSE(sgi_pool_resource_base::is_pooled(64, 128));
+    EXPECT_FALSE(sgi_pool_resource_base::is_pooled(100, 128));
+    EXPECT_TRUE(sgi_pool_resource_base::is_pooled(100, 64));
+
+    void* ptr = pool.allocate_impl(64, 128);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 128, 0);
+    pool.deallocate_impl(ptr, 64, 128);
+}
+
+namespace {
+
+struct alignas(64) padded_counter {
+    long value;
+};
+
+struct alignas(32) simd_vector {
+    float lanes[8];
+};
+
+} // namespace
+
+TEST(SGISynchronizedPoolResourceTest, OverAlignedContainers) {
+    synchronized_pool_resource mr;
+    std::pmr::list<padded_counter> counters(&mr);
+    std::pmr::vector<simd_vector> vectors(&mr);
+
+    for (int i = 0; i < 200; ++i) {
+        counters.push_back({i});
+        vectors.push_back({});
+    }
+
+    for (const padded_counter& c : counters) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(&c) % 64, 0);
+    }
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(vectors.data()) % 32, 0);
+    EXPECT_EQ(counters.back().value, 199);
+}
+
+TEST(SGIUnsynchronizedPoolResourceTest, OverAlignedContainers) {
+    unsynchronized_pool_resource mr;
+    std::pmr::list<padded_counter> counters(&mr);
+    std::pmr::vector<simd_vector> vectors(&mr);
+
+    for (int i = 0; i < 200; ++i) {
+        counters.push_back({i});
+        vectors.push_back({});
+    }
+
+    for (const padded_counter& c : counters) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(&c) % 64, 0);
+    }
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(vectors.data()) % 32, 0);
+    EXPECT_EQ(counters.back().value, 199);
+}
+
+namespace {
+
+// 记录上游调用的内存资源
+class tracking_resource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t bytes_outstanding = 0;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        bytes_outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        ++deallocations;
+        bytes_outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+TEST(SGIUpstreamResourceTest, DefaultUpstreamIsDefaultResource) {
+    synchronized_pool_resource sync_mr;
+    unsynchronized_pool_resource unsync_mr;
+
+    EXPECT_EQ(sync_mr.upstream_resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(unsync_mr.upstream_resource(), std::pmr::get_default_resource());
+}
+
+TEST(SGIUpstreamResourceTest, ChunksAndLargeObjectsGoThroughUpstream) {
+    tracking_resource upstream;
+    {
+        unsynchronized_pool_resource mr(&upstream);
+        EXPECT_EQ(mr.upstream_resource(), &upstream);
+
+        // 小对象：内存块来自上游
+        void* small = mr.allocate(16, 8);
+        EXPECT_GE(upstream.allocations, 1);
+
+        // 大对象：直接由上游分配和释放
+        std::size_t before = upstream.allocations;
+        void* large = mr.allocate(4096, 64);
+        EXPECT_EQ(upstream.allocations, before + 1);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % 64, 0);
+        mr.deallocate(large, 4096, 64);
+        EXPECT_EQ(upstream.deallocations, 1);
+
+        mr.deallocate(small, 16, 8);
+    }
+
+    // 资源销毁后所有内存都归还上游
+    EXPECT_EQ(upstream.allocations, upstream.deallocations);
+    EXPECT_EQ(upstream.bytes_outstanding, 0);
+}
+
+TEST(SGIUpstreamResourceTest, StackedOnMonotonicBuffer) {
+    alignas(64) static char buffer[1 << 16];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    synchronized_pool_resource mr(&arena);
+
+    // 所有内存来自预分配的缓冲区
+    std::pmr::list<int> lst(&mr);
+    for (int i = 0; i < 500; ++i) {
+        lst.push_back(i);
+    }
+    for (int& value : lst) {
+        EXPECT_GE(reinterpret_cast<char*>(&value), buffer);
+        EXPECT_LT(reinterpret_cast<char*>(&value), buffer + sizeof(buffer));
+    }
+
+    // 缓冲区耗尽时上游抛出 bad_alloc
+    EXPECT_THROW(static_cast<void>(mr.allocate(sizeof(buffer), 8)), std::bad_alloc);
+}
+
+TEST(SGITrimTest, ReleaseReturnsFullyFreeChunks) {
+    tracking_resource upstream;
+    sgi_pool_resource_base pool(&upstream);
+
+    // 流量高峰后全部释放，所有内存块都应能归还上游
+    std::vector<std::pair<void*, std::size_t>> allocations;
+    for (int i = 0; i < 10000; ++i) {
+        std::size_t size = 8 + (i * 7) % 121;
+        allocations.emplace_back(pool.allocate_impl(size, 8), size);
+    }
+    for (const auto& alloc : allocations) {
+        pool.deallocate_impl(alloc.first, alloc.second, 8);
+    }
+
+    std::size_t held = pool.held_bytes();
+    std::size_t outstanding = upstream.bytes_outstanding;
+    EXPECT_GT(pool.chunk_count(), 0u);
+
+    EXPECT_EQ(pool.release(), held);
+    EXPECT_EQ(pool.chunk_count(), 0u);
+    EXPECT_EQ(pool.held_bytes(), 0u);
+    EXPECT_EQ(upstream.bytes_outstanding, outstanding - held);
+
+    // 归还后仍可正常分配
+    void* p = pool.allocate_impl(32, 8);
+    EXPECT_NE(p, nullptr);
+    EXPECT_EQ(pool.chunk_count(), 1u);
+    pool.deallocate_impl(p, 32, 8);
+}
+
+TEST(SGITrimTest, ReleaseKeepsChunksInUse) {
+    sgi_pool_resource_base pool;
+
+    // 第一个对象一直存活，它所在的内存块不能归还
+    void* live = pool.allocate_impl(16, 8);
+    std::vector<void*> pointers;
+    for (int i = 0; i < 5000; ++i) {
+        pointers.push_back(pool.allocate_impl(16, 8));
+    }
+    for (void* p : pointers) {
+        pool.deallocate_impl(p, 16, 8);
+    }
+
+    EXPECT_GT(pool.chunk_count(), 1u);
+    EXPECT_GT(pool.release(), 0u);
+    EXPECT_EQ(pool.chunk_count(), 1u);
+
+    // 留下的块中其余对象仍在空闲链表中
+    std::memset(live, 0x5a, 16);
+    void* again = pool.allocate_impl(16, 8);
+    EXPECT_NE(again, live);
+    pool.deallocate_impl(again, 16, 8);
+
+    pool.deallocate_impl(live, 16, 8);
+    pool.release();
+    EXPECT_EQ(pool.chunk_count(), 0u);
+}
+
+TEST(SGITrimTest, TrimStopsAtTarget) {
+    sgi_pool_resource_base pool;
+
+    std::vector<void*> pointers;
+    for (int i = 0; i < 20000; ++i) {
+        pointers.push_back(pool.allocate_impl(64, 8));
+    }
+    for (void* p : pointers) {
+        pool.deallocate_impl(p, 64, 8);
+    }
+
+    // 只归还到目标大小为止，剩余的块留待后续分配
+    std::size_t held = pool.held_bytes();
+    std::size_t chunks = pool.chunk_count();
+    pool.trim(held / 2);
+    EXPECT_LE(pool.held_bytes(), held / 2);
+    EXPECT_GT(pool.chunk_count(), 0u);
+    EXPECT_LT(pool.chunk_count(), chunks);
+
+    // 目标不小于持有量时不归还任何块
+    EXPECT_EQ(pool.trim(pool.held_bytes()), 0u);
+}
+
+TEST(SGITrimTest, LeftoversAreAccountedFor) {
+    constexpr pool_options options{.max_bytes = 512, .spacing = size_class_spacing::geometric};
+    basic_sgi_pool_resource_base<options> pool;
+
+    // 几何间隔下零头会落在两个大小类之间，拆分后仍能判断块完全空闲
+    std::vector<std::pair<void*, std::size_t>> allocations;
+    for (int i = 0; i < 5000; ++i) {
+        std::size_t size = 8 + (i * 37) % 505;
+        allocations.emplace_back(pool.allocate_impl(size, 8), size);
+    }
+    for (const auto& alloc : allocations) {
+        pool.deallocate_impl(alloc.first, alloc.second, 8);
+    }
+
+    pool.release();
+    EXPECT_EQ(pool.chunk_count(), 0u);
+}
+
+TEST(SGITrimTest, DecayReleasesIdleChunks) {
+    constexpr pool_options options{.decay_ms = 20};
+    basic_sgi_pool_resource_base<options> pool;
+
+    std::vector<void*> pointers;
+    for (int i = 0; i < 1000; ++i) {
+        pointers.push_back(pool.allocate_impl(24, 8));
+    }
+    for (void* p : pointers) {
+        pool.deallocate_impl(p, 24, 8);
+    }
+
+    // 第一次扫描只记录空闲时间，超过阈值后的扫描才归还
+    EXPECT_EQ(pool.decay(), 0u);
+    EXPECT_GT(pool.chunk_count(), 0u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_GT(pool.decay(), 0u);
+    EXPECT_EQ(pool.chunk_count(), 0u);
+}
+
+TEST(SGITrimTest, DecayRunsFromDeallocationPath) {
+    constexpr pool_options options{.decay_ms = 1};
+    basic_sgi_pool_resource_base<options> pool;
+
+    std::vector<void*> pointers;
+    for (int i = 0; i < 4000; ++i) {
+        pointers.push_back(pool.allocate_impl(96, 8));
+    }
+    for (void* p : pointers) {
+        pool.deallocate_impl(p, 96, 8);
+    }
+    std::size_t peak = pool.held_bytes();
+
+    // 空闲块在后续的释放中被自动归还，无需显式调用
+    for (int round = 0; round < 50 && pool.held_bytes() == peak; ++round) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        for (std::size_t i = 0; i < 1024; ++i) {
+            pool.deallocate_impl(pool.allocate_impl(8, 8), 8, 8);
+        }
+    }
+    EXPECT_LT(pool.held_bytes(), peak);
+}
+
+TEST(SGITrimTest, ScanDoesNotAllocate) {
+    tracking_resource upstream;
+    constexpr pool_options options{.decay_ms = 20};
+    basic_sgi_pool_resource_base<options> pool(&upstream);
+
+    std::vector<void*> pointers;
+    for (int i = 0; i < 4000; ++i) {
+        pointers.push_back(pool.allocate_impl(8 + (i % 16) * 8, 8));
+    }
+    for (int i = 0; i < 4000; ++i) {
+        pool.deallocate_impl(pointers[i], 8 + (i % 16) * 8, 8);
+    }
+
+    // 扫描表在添加内存块时已经预留，衰减和 trim 都不再向上游申请
+    std::size_t before = upstream.allocations;
+    EXPECT_EQ(pool.decay(), 0u);
+    EXPECT_GT(pool.release(), 0u);
+    EXPECT_EQ(upstream.allocations, before);
+}
+
+TEST(SGITrimTest, SynchronizedResourceRelease) {
+    synchronized_pool_resource mr;
+    {
+        std::pmr::list<int> lst(&mr);
+        for (int i = 0; i < 10000; ++i) {
+            lst.push_back(i);
+        }
+    }
+
+    EXPECT_GT(mr.release(), 0u);
+    EXPECT_EQ(mr.release(), 0u);
+
+    std::pmr::vector<int> vec(&mr);
+    vec.assign(100, 7);
+    EXPECT_EQ(vec.back(), 7);
+}
+
+namespace {
+
+constexpr pool_options stats_options{.enable_stats = true};
+
+template <typename T>
+concept has_stats = requires(T& t) { t.stats(); };
+
+} // namespace
+
+TEST(SGIStatsTest, DisabledStatsCompileAway) {
+    // 关闭统计时不提供 stats()，计数器也不占空间
+    static_assert(!has_stats<sgi_pool_resource_base>);
+    static_assert(!has_stats<synchronized_pool_resource>);
+    static_assert(has_stats<basic_sgi_pool_resource_base<stats_options>>);
+    static_assert(sizeof(basic_sgi_pool_resource_base<stats_options>) > sizeof(sgi_pool_resource_base));
+}
+
+TEST(SGIStatsTest, CountsPerSizeClass) {
+    basic_unsynchronized_pool_resource<stats_options> mr;
+
+    std::vector<void*> pointers;
+    for (int i = 0; i < 100; ++i) {
+        pointers.push_back(mr.allocate(16, 8));
+    }
+    for (int i = 0; i < 40; ++i) {
+        mr.deallocate(pointers[i], 16, 8);
+    }
+
+    pool_stats stats = mr.stats();
+    const size_class_stats& c = stats.size_classes[sgi_pool_resource_base::size_class_index(16)];
+    EXPECT_EQ(c.bytes, 16u);
+    EXPECT_EQ(c.allocations, 100u);
+    EXPECT_EQ(c.deallocations, 40u);
+    EXPECT_EQ(c.high_water, 100u);
+    EXPECT_GE(c.refills, 100u / stats_options.refill_batch);
+    EXPECT_GE(c.free_list_length, 40u);
+
+    // 其他大小类没有流量
+    const size_class_stats& other = stats.size_classes[sgi_pool_resource_base::size_class_index(64)];
+    EXPECT_EQ(other.allocations, 0u);
+    EXPECT_EQ(other.refills, 0u);
+
+    for (int i = 40; i < 100; ++i) {
+        mr.deallocate(pointers[i], 16, 8);
+    }
+}
+
+TEST(SGIStatsTest, LargeAllocationsAndHighWater) {
+    basic_synchronized_pool_resource<stats_options> mr;
+
+    void* large1 = mr.allocate(1000, 8);
+    void* large2 = mr.allocate(3000, 8);
+    mr.deallocate(large1, 1000, 8);
+
+    pool_stats stats = mr.stats();
+    EXPECT_EQ(stats.large_allocations, 2u);
+    EXPECT_EQ(stats.large_deallocations, 1u);
+    EXPECT_EQ(stats.large_bytes, 3000u);
+    mr.deallocate(large2, 3000, 8);
+
+    // 峰值在释放后保持不变
+    std::size_t index = sgi_pool_resource_base::size_class_index(32);
+    for (int round = 0; round < 3; ++round) {
+        std::vector<void*> pointers;
+        for (int i = 0; i < 50; ++i) {
+            pointers.push_back(mr.allocate(32, 8));
+        }
+        for (void* p : pointers) {
+            mr.deallocate(p, 32, 8);
+        }
+    }
+    stats = mr.stats();
+    EXPECT_EQ(stats.size_classes[index].allocations, 150u);
+    EXPECT_EQ(stats.size_classes[index].high_water, 50u);
+}
+
+TEST(SGIStatsTest, FragmentationRatio) {
+    basic_sgi_pool_resource_base<stats_options> pool;
+
+    std::vector<std::pair<void*, std::size_t>> allocations;
+    for (int i = 0; i < 2000; ++i) {
+        std::size_t size = 8 + (i * 13) % 121;
+        allocations.emplace_back(pool.allocate_impl(size, 8), size);
+    }
+
+    pool_stats busy = pool.stats();
+    EXPECT_EQ(busy.chunk_count, pool.chunk_count());
+    EXPECT_EQ(busy.held_bytes, pool.held_bytes());
+    EXPECT_LT(busy.fragmentation_ratio(), 0.5);
+
+    for (const auto& alloc : allocations) {
+        pool.deallocate_impl(alloc.first, alloc.second, 8);
+    }
+
+    // 全部释放后内存块中每个字节都是空闲的
+    pool_stats idle = pool.stats();
+    EXPECT_EQ(idle.free_bytes, idle.held_bytes);
+    EXPECT_DOUBLE_EQ(idle.fragmentation_ratio(), 1.0);
+}
+
+TEST(SGIBulkTest, AllocatesDistinctObjectsAndReusesThem) {
+    sgi_pool_resource_base pool;
+
+    std::vector<void*> first(1000);
+    pool.allocate_bulk(24, 8, first.size(), first.data());
+    for (void* p : first) {
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 8, 0);
+        std::memset(p, 0xAB, 24);
+    }
+    std::vector<void*> sorted = first;
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(std::adjacent_find(sorted.begin(), sorted.end()), sorted.end());
+
+    // 整批释放后再整批分配，全部来自空闲链表，不再向上游申请
+    std::size_t held = pool.held_bytes();
+    pool.deallocate_bulk(first.data(), first.size(), 24, 8);
+    std::vector<void*> second(1000);
+    pool.allocate_bulk(24, 8, second.size(), second.data());
+    EXPECT_EQ(pool.held_bytes(), held);
+
+    std::sort(second.begin(), second.end());
+    EXPECT_EQ(second, sorted);
+    pool.deallocate_bulk(second.data(), second.size(), 24, 8);
+}
+
+TEST(SGIBulkTest, MixesWithSingleObjectCalls) {
+    basic_sgi_pool_resource_base<stats_options> pool;
+    std::size_t index = pool.size_class_index(32);
+
+    std::vector<void*> objects(64);
+    pool.allocate_bulk(32, 8, objects.size(), objects.data());
+
+    // 批量分配的对象可以逐个释放，反之亦然
+    for (std::size_t i = 0; i < 32; ++i) {
+        pool.deallocate_impl(objects[i], 32, 8);
+    }
+    for (std::size_t i = 0; i < 32; ++i) {
+        objects[i] = pool.allocate_impl(32, 8);
+    }
+    pool.deallocate_bulk(objects.data(), objects.size(), 32, 8);
+
+    pool_stats stats = pool.stats();
+    EXPECT_EQ(stats.size_classes[index].allocations, 96u);
+    EXPECT_EQ(stats.size_classes[index].deallocations, 96u);
+    EXPECT_EQ(stats.size_classes[index].high_water, 64u);
+    EXPECT_EQ(stats.free_bytes, stats.held_bytes);
+}
+
+TEST(SGIBulkTest, LargeObjectsGoThroughUpstream) {
+    tracking_resource upstream;
+    {
+        unsynchronized_pool_resource mr(&upstream);
+        std::vector<void*> objects(10);
+        mr.allocate_bulk(4096, 64, objects.size(), objects.data());
+        EXPECT_EQ(upstream.allocations, 10u);
+        for (void* p : objects) {
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0);
+        }
+        mr.deallocate_bulk(objects.data(), objects.size(), 4096, 64);
+        EXPECT_EQ(upstream.deallocations, 10u);
+    }
+    EXPECT_EQ(upstream.bytes_outstanding, 0);
+}
+
+TEST(SGIBulkTest, FailureReturnsTakenObjects) {
+    alignas(64) static char buffer[1 << 14];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    basic_sgi_pool_resource_base<stats_options> pool(&arena);
+
+    // 上游只有 16KB，无法满足 4096 个 16 字节对象
+    std::vector<void*> objects(4096);
+    EXPECT_THROW(pool.allocate_bulk(16, 8, objects.size(), objects.data()), std::bad_alloc);
+
+    // 已取出的对象都回到了空闲链表
+    pool_stats stats = pool.stats();
+    EXPECT_EQ(stats.size_classes[pool.size_class_index(16)].allocations, 0u);
+    EXPECT_EQ(stats.free_bytes, stats.held_bytes);
+
+    std::vector<void*> fits(100);
+    pool.allocate_bulk(16, 8, fits.size(), fits.data());
+    pool.deallocate_bulk(fits.data(), fits.size(), 16, 8);
+}
+
+TEST(SGIBulkTest, ChainFailureReturnsTakenObjects) {
+    alignas(64) static char buffer[1 << 14];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    basic_sgi_pool_resource_base<stats_options> pool(&arena);
+
+    // 上游只有 16KB，整条链无法取满
+    void* head;
+    void* tail;
+    EXPECT_THROW(pool.allocate_chain(pool.size_class_index(16), 4096, head, tail), std::bad_alloc);
+
+    // 已取出的对象都回到了空闲链表
+    pool_stats stats = pool.stats();
+    EXPECT_EQ(stats.size_classes[pool.size_class_index(16)].allocations, 0u);
+    EXPECT_EQ(stats.free_bytes, stats.held_bytes);
+
+    EXPECT_EQ(pool.allocate_chain(pool.size_class_index(16), 100, head, tail), 100u);
+    pool.deallocate_chain(pool.size_class_index(16), head, tail);
+}
+
+TEST(SGIBulkTest, PolymorphicAllocatorHelper) {
+    struct node {
+        node* next;
+        int value;
+    };
+
+    synchronized_pool_resource mr;
+    polymorphic_allocator<node> alloc(&mr);
+    std::vector<node*> nodes(500);
+    alloc.allocate_bulk(nodes.size(), nodes.data());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i]->value = static_cast<int>(i);
+    }
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        EXPECT_EQ(nodes[i]->value, static_cast<int>(i));
+    }
+    alloc.deallocate_bulk(nodes.data(), nodes.size());
+
+    // 不支持批量接口的资源逐个分配
+    polymorphic_allocator<node> fallback(std::pmr::new_delete_resource());
+    fallback.allocate_bulk(nodes.size(), nodes.data());
+    for (node* n : nodes) {
+        n->value = 1;
+    }
+    fallback.deallocate_bulk(nodes.data(), nodes.size());
+}
+
+TEST(SGIBulkTest, SynchronizedThreadSafety) {
+    synchronized_pool_resource mr;
+    constexpr int NUM_THREADS = 4;
+    constexpr int ROUNDS = 200;
+    std::atomic<int> errors{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&mr, &errors, t]() {
+            std::vector<void*> objects(256);
+            for (int r = 0; r < ROUNDS; ++r) {
+                mr.allocate_bulk(48, 8, objects.size(), objects.data());
+                for (void* p : objects) {
+                    *static_cast<int*>(p) = t;
+                }
+                for (void* p : objects) {
+                    if (*static_cast<int*>(p) != t) {
+                        ++errors;
+                    }
+                }
+                mr.deallocate_bulk(objects.data(), objects.size(), 48, 8);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(errors.load(), 0);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
+namespace {
+
+constexpr pool_options adaptive_options{
+    .refill_batch = 4,
+    .min_refill_batch = 2,
+    .max_refill_batch = 256,
+    .enable_stats = true,
+};
+
+} // namespace
+
+TEST(SGIAdaptiveRefillTest, FixedBatchByDefault) {
+    // 默认配置批量固定，不为自适应状态占用空间
+    sgi_pool_resource_base base;
+    for (std::size_t i = 0; i < sgi_pool_resource_base::size_class_count(); ++i) {
+        EXPECT_EQ(base.refill_batch(i), pool_options{}.refill_batch);
+    }
+    static_assert(sizeof(basic_sgi_pool_resource_base<pool_options{.refill_batch = 8}>) ==
+                  sizeof(sgi_pool_resource_base));
+    static_assert(sizeof(basic_sgi_pool_resource_base<pool_options{.max_refill_batch = 64}>) >
+                  sizeof(sgi_pool_resource_base));
+}
+
+TEST(SGIAdaptiveRefillTest, HotClassGrowsGeometrically) {
+    basic_sgi_pool_resource_base<adaptive_options> base;
+    std::size_t index = base.size_class_index(16);
+
+    std::vector<void*> pointers;
+    for (int i = 0; i < 4000; ++i) {
+        pointers.push_back(base.allocate_impl(16, 8));
+    }
+    EXPECT_EQ(base.refill_batch(index), adaptive_options.max_refill_batch);
+
+    // 固定批量 4 需要 1000 次 refill
+    pool_stats stats = base.stats();
+    EXPECT_LT(stats.size_classes[index].refills, 30u);
+    EXPECT_EQ(stats.size_classes[index].refill_batch, adaptive_options.max_refill_batch);
+
+    for (void* p : pointers) {
+        base.deallocate_impl(p, 16, 8);
+    }
+}
+
+TEST(SGIAdaptiveRefillTest, ColdClassShrinks) {
+    basic_sgi_pool_resource_base<adaptive_options> base;
+    std::size_t cold = base.size_class_index(16);
+    std::size_t hot = base.size_class_index(64);
+
+    std::vector<void*> cold_pointers;
+    for (int i = 0; i < 200; ++i) {
+        cold_pointers.push_back(base.allocate_impl(16, 8));
+    }
+    std::size_t grown = base.refill_batch(cold);
+    EXPECT_GT(grown, adaptive_options.refill_batch);
+
+    // 其他大小类 refill 很多次之后，冷门大小类的下一次 refill 批量减半
+    std::vector<void*> hot_pointers;
+    for (int i = 0; i < 30000; ++i) {
+        hot_pointers.push_back(base.allocate_impl(64, 8));
+    }
+    EXPECT_EQ(base.refill_batch(hot), adaptive_options.max_refill_batch);
+
+    while (base.refill_batch(cold) == grown) {
+        cold_pointers.push_back(base.allocate_impl(16, 8));
+    }
+    EXPECT_LT(base.refill_batch(cold), grown);
+    EXPECT_GE(base.refill_batch(cold), adaptive_options.min_refill_batch);
+
+    for (void* p : cold_pointers) {
+        base.deallocate_impl(p, 16, 8);
+    }
+    for (void* p : hot_pointers) {
+        base.deallocate_impl(p, 64, 8);
+    }
+}
+
+TEST(SGIAdaptiveRefillTest, ColdClassesHoldLessMemory) {
+    // 每个大小类只用一个对象时，自适应批量从较小的初始值开始切分
+    basic_unsynchronized_pool_resource<pool_options{.refill_batch = 256, .enable_stats = true}> fixed;
+    basic_unsynchronized_pool_resource<adaptive_options> adaptive;
+
+    std::vector<std::pair<void*, void*>> pointers;
+    for (std::size_t bytes = 8; bytes <= 128; bytes += 8) {
+        pointers.emplace_back(fixed.allocate(bytes, 8), adaptive.allocate(bytes, 8));
+    }
+    EXPECT_LT(adaptive.stats().held_bytes * 4, fixed.stats().held_bytes);
+
+    std::size_t bytes = 8;
+    for (auto [a, b] : pointers) {
+        fixed.deallocate(a, bytes, 8);
+        adaptive.deallocate(b, bytes, 8);
+        bytes += 8;
+    }
+}
+
+namespace {
+
+constexpr pool_options span_options{.enable_stats = true, .size_class_spans = true};
+
+// 检查释放时的大小和对齐与分配时一致的上游资源
+class checking_resource : public std::pmr::memory_resource {
+public:
+    std::map<void*, std::pair<std::size_t, std::size_t>> live;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        live[p] = {bytes, alignment};
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        auto it = live.find(p);
+        EXPECT_NE(it, live.end());
+        if (it != live.end()) {
+            EXPECT_EQ(it->second.first, bytes);
+            EXPECT_EQ(it->second.second, alignment);
+            live.erase(it);
+        }
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+TEST(SGISpanTest, UnsizedFreeReturnsObjectToItsClass) {
+    basic_sgi_pool_resource_base<span_options> base;
+
+    void* a = base.allocate_impl(24, 8);
+    void* b = base.allocate_impl(100, 8);
+    EXPECT_TRUE(base.owns(a));
+    EXPECT_EQ(base.allocation_size(a), 24u);
+    EXPECT_EQ(base.allocation_size(b), 104u);
+
+    EXPECT_TRUE(base.deallocate_unsized(a));
+    EXPECT_TRUE(base.deallocate_unsized(b));
+    EXPECT_TRUE(base.deallocate_unsized(nullptr));
+
+    // 对象回到各自大小类的空闲链表头部
+    EXPECT_EQ(base.allocate_impl(24, 8), a);
+    EXPECT_EQ(base.allocate_impl(100, 8), b);
+    base.deallocate_impl(a, 24, 8);
+    base.deallocate_impl(b, 100, 8);
+}
+
+TEST(SGISpanTest, ForeignPointersAreNotOwned) {
+    basic_sgi_pool_resource_base<span_options> base;
+    void* pooled = base.allocate_impl(16, 8);
+
+    void* foreign = std::malloc(16);
+    int local = 0;
+    EXPECT_FALSE(base.owns(foreign));
+    EXPECT_FALSE(base.owns(&local));
+    EXPECT_EQ(base.allocation_size(foreign), 0u);
+    EXPECT_FALSE(base.deallocate_unsized(foreign));
+    std::free(foreign);
+
+    // 另一个资源的对象同样不属于本资源
+    basic_sgi_pool_resource_base<span_options> other;
+    void* theirs = other.allocate_impl(16, 8);
+    EXPECT_FALSE(base.owns(theirs));
+    EXPECT_TRUE(other.owns(theirs));
+    other.deallocate_impl(theirs, 16, 8);
+
+    base.deallocate_impl(pooled, 16, 8);
+}
+
+TEST(SGISpanTest, LargeObjectsAreRoundedToPagesAndFreedUnsized) {
+    checking_resource upstream;
+    {
+        basic_sgi_pool_resource_base<span_options> base(&upstream);
+
+        void* large = base.allocate_impl(10000, 8);
+        void* aligned = base.allocate_impl(5000, 8192);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 8192, 0u);
+        EXPECT_TRUE(base.owns(large));
+        EXPECT_EQ(base.allocation_size(large), 3 * detail::PAGE_SIZE);
+        EXPECT_EQ(base.allocation_size(aligned), 2 * detail::PAGE_SIZE);
+        EXPECT_EQ(base.stats().large_bytes, 5 * detail::PAGE_SIZE);
+
+        EXPECT_TRUE(base.deallocate_unsized(large));
+        EXPECT_FALSE(base.owns(large));
+        base.deallocate_impl(aligned, 5000, 8192);
+        EXPECT_EQ(base.stats().large_bytes, 0u);
+    }
+    EXPECT_TRUE(upstream.live.empty());
+}
+
+TEST(SGISpanTest, SizeClassesDoNotShareChunks) {
+    checking_resource upstream;
+    basic_sgi_pool_resource_base<span_options> base(&upstream);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::size_t> size_dist(1, 128);
+    std::vector<std::pair<void*, std::size_t>> objects;
+    for (int i = 0; i < 5000; ++i) {
+        std::size_t bytes = size_dist(rng);
+        void* p = base.allocate_impl(bytes, 8);
+        EXPECT_EQ(base.allocation_size(p), base.size_class_bytes(base.size_class_index(bytes)));
+        objects.emplace_back(p, bytes);
+    }
+
+    // 不带大小释放全部对象后，每个块都完全空闲，可以整体归还
+    std::shuffle(objects.begin(), objects.end(), rng);
+    for (auto [p, bytes] : objects) {
+        EXPECT_TRUE(base.deallocate_unsized(p));
+    }
+    EXPECT_GT(base.release(), 0u);
+    EXPECT_EQ(base.held_bytes(), 0u);
+    EXPECT_EQ(base.chunk_count(), 0u);
+    // 上游只剩簿记数据（记录内存块的数组、扫描表和页映射节点，节点数取决于块的地址），没有按页对齐的内存块
+    for (const auto& [q, request] : upstream.live) {
+        EXPECT_LT(request.second, detail::PAGE_SIZE);
+    }
+
+    // 归还后页映射不再认领这些地址，新的分配照常进行
+    EXPECT_FALSE(base.owns(objects.front().first));
+    void* p = base.allocate_impl(40, 8);
+    EXPECT_TRUE(base.owns(p));
+    base.deallocate_impl(p, 40, 8);
+}
+
+TEST(SGISpanTest, SynchronizedResourceUnsizedFree) {
+    basic_synchronized_pool_resource<span_options> mr;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&mr, t] {
+            std::vector<void*> pointers;
+            for (int i = 0; i < 1000; ++i) {
+                pointers.push_back(mr.allocate(8 + (i + t) % 200, 8));
+            }
+            for (void* p : pointers) {
+                EXPECT_TRUE(mr.owns(p));
+                EXPECT_TRUE(mr.deallocate_unsized(p));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    int local = 0;
+    EXPECT_FALSE(mr.deallocate_unsized(&local));
+    pool_stats stats = mr.stats();
+    EXPECT_EQ(stats.large_bytes, 0u);
+    EXPECT_EQ(stats.large_allocations, stats.large_deallocations);
+}
+
+namespace {
+
+constexpr pool_options medium_options{.enable_stats = true, .medium_max_bytes = 32768};
+
+} // namespace
+
+TEST(SGIMediumTierTest, SizeClassTable) {
+    using table = detail::size_class_table<medium_options>;
+    using base = basic_sgi_pool_resource_base<medium_options>;
+
+    // 小对象层保持 16 个线性大小类，中等对象层从 160 开始每次翻倍 4 个，直到 32KB
+    ASSERT_EQ(table::small_count, 16u);
+    ASSERT_EQ(table::count, 16u + 4 * 8);
+    for (std::size_t i = 0; i < table::small_count; ++i) {
+        EXPECT_EQ(table::sizes[i], (i + 1) * 8);
+    }
+    EXPECT_EQ(table::sizes[16], 160u);
+    EXPECT_EQ(table::sizes[20], 320u);
+    EXPECT_EQ(table::sizes[table::count - 1], 32768u);
+
+    for (std::size_t bytes = 1; bytes <= 32768; ++bytes) {
+        std::size_t index = base::size_class_index(bytes);
+        EXPECT_GE(base::size_class_bytes(index), bytes);
+        if (index > 0) {
+            EXPECT_LT(base::size_class_bytes(index - 1), bytes);
+        }
+    }
+    EXPECT_TRUE(base::is_pooled(32768, 8));
+    EXPECT_FALSE(base::is_pooled(32769, 8));
+}
+
+TEST(SGIMediumTierTest, MediumObjectsArePooled) {
+    tracking_resource upstream;
+    basic_sgi_pool_resource_base<medium_options> pool(&upstream);
+
+    // 中等对象不经过上游的大对象路径，释放后被同一大小类重用
+    void* a = pool.allocate_impl(200, 8);
+    void* b = pool.allocate_impl(4000, 8);
+    void* c = pool.allocate_impl(32768, 8);
+    void* d = pool.allocate_impl(1000, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(d) % 64, 0u);
+    EXPECT_EQ(pool.stats().large_allocations, 0u);
+
+    // 每个中等大小类的第一个 span 从页边界开始
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % detail::PAGE_SIZE, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c) % detail::PAGE_SIZE, 0u);
+
+    std::size_t chunks = upstream.allocations;
+    pool.deallocate_impl(b, 4000, 8);
+    EXPECT_EQ(pool.allocate_impl(3900, 8), b);
+    EXPECT_EQ(upstream.allocations, chunks);
+
+    // 超过 medium_max_bytes 的请求仍然交给上游
+    void* large = pool.allocate_impl(40000, 8);
+    EXPECT_EQ(upstream.allocations, chunks + 1);
+    EXPECT_EQ(pool.stats().large_allocations, 1u);
+    pool.deallocate_impl(large, 40000, 8);
+
+    pool.deallocate_impl(a, 200, 8);
+    pool.deallocate_impl(b, 3900, 8);
+    pool.deallocate_impl(c, 32768, 8);
+    pool.deallocate_impl(d, 1000, 64);
+}
+
+TEST(SGIMediumTierTest, ReleaseReturnsAllChunksAfterMixedSizes) {
+    tracking_resource upstream;
+    basic_sgi_pool_resource_base<medium_options> pool(&upstream);
+
+    // span 切换留下的零头挂入小对象空闲链表，全部释放后每个块都能归还
+    std::mt19937 rng(5);
+    std::vector<std::pair<void*, std::size_t>> objects;
+    for (int i = 0; i < 5000; ++i) {
+        std::size_t bytes = std::size_t{8} << (rng() % 13);
+        bytes = bytes / 2 + rng() % (bytes / 2) + 1;
+        void* p = pool.allocate_impl(bytes, 8);
+        std::memset(p, 0x5a, bytes);
+        objects.emplace_back(p, bytes);
+    }
+    std::shuffle(objects.begin(), objects.end(), rng);
+    for (auto [p, bytes] : objects) {
+        pool.deallocate_impl(p, bytes, 8);
+    }
+
+    EXPECT_EQ(pool.stats().fragmentation_ratio(), 1.0);
+    std::size_t held = pool.held_bytes();
+    std::size_t outstanding = upstream.bytes_outstanding;
+    EXPECT_EQ(pool.release(), held);
+    EXPECT_EQ(pool.chunk_count(), 0u);
+    EXPECT_EQ(upstream.bytes_outstanding, outstanding - held);
+}
+
+TEST(SGIMediumTierTest, WorksWithSizeClassSpans) {
+    constexpr pool_options options{.size_class_spans = true, .medium_max_bytes = 32768};
+    basic_synchronized_pool_resource<options> mr;
+
+    void* p = mr.allocate(3000, 8);
+    EXPECT_TRUE(mr.owns(p));
+    EXPECT_EQ(mr.allocation_size(p), 3072u);
+    EXPECT_TRUE(mr.deallocate_unsized(p));
+    EXPECT_EQ(mr.allocate(2900, 8), p);
+    mr.deallocate(p, 2900, 8);
+}
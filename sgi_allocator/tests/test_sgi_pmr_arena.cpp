@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "../include/sgi_pmr_arena.hpp"
+#include "../include/sgi_pmr_allocator.hpp"
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace sgi_pmr;
+
+namespace {
+
+// 记录上游调用的内存资源
+class counting_resource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+TEST(SGIArenaResourceTest, BumpAllocationRespectsAlignment) {
+    counting_resource upstream;
+    arena_resource arena(&upstream);
+
+    char* a = static_cast<char*>(arena.allocate(10, 1));
+    char* b = static_cast<char*>(arena.allocate(24, 8));
+    void* c = arena.allocate(64, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 8, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c) % 64, 0u);
+    EXPECT_GE(b, a + 10);
+
+    // 所有对象来自同一个块
+    EXPECT_EQ(upstream.allocations, 1u);
+    EXPECT_EQ(arena.block_count(), 1u);
+}
+
+TEST(SGIArenaResourceTest, ResetReusesCachedBlocks) {
+    counting_resource upstream;
+    arena_resource arena(&upstream, 4096, 4);
+
+    for (int i = 0; i < 1000; ++i) {
+        static_cast<void>(arena.allocate(32, 8));
+    }
+    std::size_t blocks = arena.block_count();
+    EXPECT_GT(blocks, 4u);
+    EXPECT_EQ(upstream.allocations, blocks);
+
+    // 超出缓存上限的块归还上游
+    arena.reset();
+    EXPECT_EQ(arena.block_count(), 0u);
+    EXPECT_EQ(arena.cached_block_count(), 4u);
+    EXPECT_EQ(upstream.deallocations, blocks - 4);
+
+    // 下一轮先用完缓存的块
+    std::size_t before = upstream.allocations;
+    for (int i = 0; i < 300; ++i) {
+        static_cast<void>(arena.allocate(32, 8));
+    }
+    EXPECT_EQ(upstream.allocations, before);
+    EXPECT_EQ(arena.cached_block_count(), 4u - arena.block_count());
+}
+
+TEST(SGIArenaResourceTest, OversizedRequestsAreReturnedOnReset) {
+    counting_resource upstream;
+    arena_resource arena(&upstream, 4096, 4);
+
+    void* small = arena.allocate(16, 8);
+    void* large = arena.allocate(100000, 256);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large) % 256, 0u);
+    std::memset(large, 0, 100000);
+
+    // 大块不影响当前块，之后的小对象继续在同一块中分配
+    void* next = arena.allocate(16, 8);
+    EXPECT_EQ(static_cast<char*>(next), static_cast<char*>(small) + 16);
+    EXPECT_EQ(upstream.allocations, 2u);
+
+    arena.reset();
+    EXPECT_EQ(upstream.deallocations, 1u);
+    EXPECT_EQ(arena.cached_block_count(), 1u);
+}
+
+TEST(SGIArenaResourceTest, LastAllocationCanBeUndone) {
+    arena_resource arena;
+    void* a = arena.allocate(100, 8);
+    arena.deallocate(a, 100, 8);
+    EXPECT_EQ(arena.allocate(100, 8), a);
+
+    // 更早的分配释放后不会被复用
+    void* b = arena.allocate(16, 8);
+    arena.deallocate(a, 100, 8);
+    EXPECT_NE(arena.allocate(16, 8), b);
+}
+
+TEST(SGIArenaResourceTest, ReleaseReturnsEverything) {
+    counting_resource upstream;
+    {
+        arena_resource arena(&upstream, 4096, 8);
+        for (int i = 0; i < 500; ++i) {
+            static_cast<void>(arena.allocate(64, 8));
+        }
+        static_cast<void>(arena.allocate(10000, 8));
+        arena.release();
+        EXPECT_EQ(arena.cached_block_count(), 0u);
+        EXPECT_EQ(upstream.allocations, upstream.deallocations);
+
+        static_cast<void>(arena.allocate(64, 8));
+    }
+    // 析构时归还剩余的块
+    EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(SGIArenaResourceTest, RequestLoopOnSGIPool) {
+    unsynchronized_pool_resource pool;
+    arena_resource arena(&pool, 16384);
+
+    for (int request = 0; request < 20; ++request) {
+        {
+            std::pmr::map<int, std::pmr::string> headers(&arena);
+            for (int i = 0; i < 200; ++i) {
+                headers.emplace(i, std::pmr::string("value number " + std::to_string(i) + " of the request", &arena));
+            }
+            EXPECT_EQ(headers.size(), 200u);
+            EXPECT_EQ(headers[150], "value number 150 of the request");
+        }
+        arena.reset();
+        EXPECT_LE(arena.cached_block_count(), arena_resource::DEFAULT_CACHED_BLOCKS);
+    }
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "../include/sgi_pmr_huge_page.hpp"
+#include "../include/sgi_pmr_allocator.hpp"
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+using namespace sgi_pmr;
+
+TEST(SGIHugePageResourceTest, BasicAllocationDeallocation) {
+    huge_page_resource mr;
+
+    void* ptr = mr.allocate(1024, 8);
+    EXPECT_NE(ptr, nullptr);
+    std::memset(ptr, 0xab, 1024);
+    mr.deallocate(ptr, 1024, 8);
+
+    // 首个区域保留后才有地址空间
+    EXPECT_GE(mr.reserved_bytes(), huge_page_resource::DEFAULT_REGION_BYTES);
+}
+
+TEST(SGIHugePageResourceTest, AlignmentRequirements) {
+    huge_page_resource mr;
+
+    // 默认按 BLOCK_ALIGN 对齐，更大的对齐同样满足
+    for (std::size_t alignment : {8, 64, 256, 4096}) {
+        void* ptr = mr.allocate(100, alignment);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignment, 0u);
+        mr.deallocate(ptr, 100, alignment);
+    }
+}
+
+TEST(SGIHugePageResourceTest, FreedBlocksAreReused) {
+    huge_page_resource mr(huge_page_resource::HUGE_PAGE_SIZE);
+
+    // 释放后合并的块可以满足更大的请求，不需要保留新区域
+    std::vector<void*> pointers;
+    for (int i = 0; i < 16; ++i) {
+        pointers.push_back(mr.allocate(64 * 1024, 8));
+    }
+    for (void* ptr : pointers) {
+        mr.deallocate(ptr, 64 * 1024, 8);
+    }
+
+    std::size_t reserved = mr.reserved_bytes();
+    void* big = mr.allocate(16 * 64 * 1024, 8);
+    EXPECT_EQ(big, pointers.front());
+    EXPECT_EQ(mr.reserved_bytes(), reserved);
+    mr.deallocate(big, 16 * 64 * 1024, 8);
+}
+
+TEST(SGIHugePageResourceTest, RequestLargerThanRegion) {
+    huge_page_resource mr(huge_page_resource::HUGE_PAGE_SIZE);
+
+    // 超过区域大小的请求单独占用一个区域
+    std::size_t bytes = 3 * huge_page_resource::HUGE_PAGE_SIZE;
+    char* ptr = static_cast<char*>(mr.allocate(bytes, 8));
+    ptr[0] = 1;
+    ptr[bytes - 1] = 2;
+    EXPECT_GE(mr.reserved_bytes(), bytes);
+    mr.deallocate(ptr, bytes, 8);
+}
+
+TEST(SGIHugePageResourceTest, ReportsPageKind) {
+    huge_page_resource mr;
+    void* ptr = mr.allocate(64, 8);
+
+    // 具体页类型取决于系统配置，这里只检查返回合法值
+    auto kind = mr.last_page_kind();
+    EXPECT_TRUE(kind == huge_page_resource::page_kind::hugetlb ||
+                kind == huge_page_resource::page_kind::transparent ||
+                kind == huge_page_resource::page_kind::normal);
+    mr.deallocate(ptr, 64, 8);
+}
+
+TEST(SGIHugePageResourceTest, AsPoolUpstream) {
+    huge_page_resource pages;
+    synchronized_pool_resource mr(&pages);
+
+    // 池的内存块和大对象都来自大页区域
+    std::pmr::list<int> lst(&mr);
+    for (int i = 0; i < 10000; ++i) {
+        lst.push_back(i);
+    }
+    std::pmr::vector<char> large(1 << 20, 'x', &mr);
+
+    EXPECT_EQ(lst.size(), 10000u);
+    EXPECT_EQ(lst.back(), 9999);
+    EXPECT_EQ(large.back(), 'x');
+    EXPECT_EQ(mr.upstream_resource(), &pages);
+    EXPECT_GE(pages.reserved_bytes(), huge_page_resource::DEFAULT_REGION_BYTES);
+}
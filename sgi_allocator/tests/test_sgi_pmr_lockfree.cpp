@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "../include/sgi_pmr_lockfree.hpp"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <map>
+#include <algorithm>
+#include <cstring>
+
+using namespace sgi_pmr;
+
+TEST(SGILockfreePoolResourceTest, BasicAllocationDeallocation) {
+    lockfree_pool_resource mr;
+
+    // 分配和释放小内存
+    void* ptr1 = mr.allocate(16, 8);
+    EXPECT_NE(ptr1, nullptr);
+    mr.deallocate(ptr1, 16, 8);
+
+    // 分配和释放大内存
+    void* ptr2 = mr.allocate(256, 8);
+    EXPECT_NE(ptr2, nullptr);
+    mr.deallocate(ptr2, 256, 8);
+}
+
+TEST(SGILockfreePoolResourceTest, MemoryReuse) {
+    lockfree_pool_resource mr;
+
+    // 栈式重用：最后释放的对象最先被分配
+    void* ptr1 = mr.allocate(48, 8);
+    mr.deallocate(ptr1, 48, 8);
+    void* ptr2 = mr.allocate(48, 8);
+    EXPECT_EQ(ptr1, ptr2);
+    mr.deallocate(ptr2, 48, 8);
+}
+
+TEST(SGILockfreePoolResourceTest, DistinctPointersAcrossRefills) {
+    lockfree_pool_resource mr;
+    constexpr std::size_t count = lockfree_pool_resource::REFILL_BATCH * 10;
+
+    std::vector<void*> pointers;
+    for (std::size_t i = 0; i < count; ++i) {
+        pointers.push_back(mr.allocate(8, 8));
+    }
+
+    std::vector<void*> sorted = pointers;
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(std::adjacent_find(sorted.begin(), sorted.end()), sorted.end());
+
+    for (void* ptr : pointers) {
+        mr.deallocate(ptr, 8, 8);
+    }
+}
+
+TEST(SGILockfreePoolResourceTest, TaggedTopRejectsStaleSnapshot) {
+    detail::tagged_top top;
+    alignas(16) static char objects[2][16];
+
+    // 栈顶从 a 变为 b 再变回 a，指针相同但代数不同，旧快照的 CAS 必须失败
+    detail::tagged_top::snapshot stale = top.load(std::memory_order_relaxed);
+    ASSERT_TRUE(top.compare_exchange(stale, objects[0], std::memory_order_relaxed, std::memory_order_relaxed));
+    detail::tagged_top::snapshot current = top.load(std::memory_order_relaxed);
+    stale = current;
+    ASSERT_TRUE(top.compare_exchange(current, objects[1], std::memory_order_relaxed, std::memory_order_relaxed));
+    current = top.load(std::memory_order_relaxed);
+    ASSERT_TRUE(top.compare_exchange(current, objects[0], std::memory_order_relaxed, std::memory_order_relaxed));
+
+    EXPECT_FALSE(top.compare_exchange(stale, nullptr, std::memory_order_relaxed, std::memory_order_relaxed));
+    EXPECT_EQ(stale.pointer, objects[0]);
+    EXPECT_EQ(stale.tag, 3u);
+    EXPECT_TRUE(detail::tagged_top::fits(objects[0]));
+}
+
+TEST(SGILockfreePoolResourceTest, ThreadSafety) {
+    lockfree_pool_resource mr;
+    constexpr int num_threads = 8;
+    constexpr int rounds = 200;
+    constexpr int allocations_per_round = 64;
+
+    std::vector<std::thread> threads;
+    std::atomic<int> corrupted{0};
+
+    // 所有线程竞争同一组大小类，并检查对象内容未被其他线程改写
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&mr, &corrupted, i]() {
+            std::mt19937 rng(i);
+            std::uniform_int_distribution<std::size_t> size_dist(8, 64);
+            std::vector<std::pair<unsigned char*, std::size_t>> allocations;
+
+            for (int r = 0; r < rounds; ++r) {
+                for (int j = 0; j < allocations_per_round; ++j) {
+                    std::size_t size = size_dist(rng);
+                    auto* ptr = static_cast<unsigned char*>(mr.allocate(size, 8));
+                    std::memset(ptr, i + 1, size);
+                    allocations.emplace_back(ptr, size);
+                }
+
+                for (const auto& alloc : allocations) {
+                    for (std::size_t k = 0; k < alloc.second; ++k) {
+                        if (alloc.first[k] != i + 1) {
+                            ++corrupted;
+                            break;
+                        }
+                    }
+                    mr.deallocate(alloc.first, alloc.second, 8);
+                }
+                allocations.clear();
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(corrupted, 0);
+}
+
+TEST(SGILockfreePoolResourceTest, MapWithPolymorphicAllocator) {
+    lockfree_pool_resource mr;
+    std::pmr::map<int, int> m(&mr);
+
+    for (int i = 0; i < 1000; ++i) {
+        m.emplace(i, i * 2);
+    }
+
+    EXPECT_EQ(m.size(), 1000);
+    EXPECT_EQ(m.at(500), 1000);
+}
+
+TEST(SGILockfreePoolResourceTest, StatsCountLockFreePath) {
+    basic_lockfree_pool_resource<pool_options{.enable_stats = true}> mr;
+    constexpr int num_threads = 4;
+    constexpr int allocations_per_thread = 500;
+    std::size_t index = sgi_pool_resource_base::size_class_index(24);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&mr]() {
+            for (int i = 0; i < allocations_per_thread; ++i) {
+                mr.deallocate(mr.allocate(24, 8), 24, 8);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    pool_stats stats = mr.stats();
+    EXPECT_EQ(stats.size_classes[index].allocations, num_threads * allocations_per_thread);
+    EXPECT_EQ(stats.size_classes[index].deallocations, num_threads * allocations_per_thread);
+}
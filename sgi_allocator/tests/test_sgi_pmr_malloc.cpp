@@ -0,0 +1,199 @@
+// sgi_pmr_malloc 静态链接进本测试可执行文件，gtest 自身的分配也经过替换后的 malloc
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __GLIBC__
+extern "C" void* __libc_memalign(std::size_t, std::size_t);
+#endif
+
+namespace {
+
+bool is_aligned(const void* p, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+} // namespace
+
+TEST(SGIMallocTest, UsesPoolSizeClasses) {
+    // 几何间隔下 5000 字节落在 5120 字节的大小类，大对象按页取整
+    void* small = std::malloc(5000);
+    void* large = std::malloc(100000);
+    ASSERT_NE(small, nullptr);
+    ASSERT_NE(large, nullptr);
+    EXPECT_EQ(malloc_usable_size(small), 5120u);
+    EXPECT_EQ(malloc_usable_size(large), 102400u);
+    EXPECT_TRUE(is_aligned(small, alignof(std::max_align_t)));
+    std::free(small);
+    std::free(large);
+    std::free(nullptr);
+}
+
+TEST(SGIMallocTest, CallocZeroesReusedMemory) {
+    void* p = std::malloc(256);
+    ASSERT_NE(p, nullptr);
+    std::memset(p, 0xff, 256);
+    std::free(p);
+
+    auto* q = static_cast<unsigned char*>(std::calloc(16, 16));
+    ASSERT_NE(q, nullptr);
+    for (int i = 0; i < 256; ++i) {
+        EXPECT_EQ(q[i], 0) << i;
+    }
+    std::free(q);
+
+    // 乘积溢出时失败；volatile 避免编译器在编译期诊断
+    volatile std::size_t count = SIZE_MAX / 2;
+    errno = 0;
+    EXPECT_EQ(std::calloc(count, 4), nullptr);
+    EXPECT_EQ(errno, ENOMEM);
+}
+
+TEST(SGIMallocTest, ReallocPreservesContents) {
+    auto* p = static_cast<char*>(std::realloc(nullptr, 40));
+    ASSERT_NE(p, nullptr);
+    std::memcpy(p, "0123456789", 10);
+
+    // 缩小到一半以上时原地返回；p 传给 realloc 后不再读取，只比较地址值
+    auto before = reinterpret_cast<std::uintptr_t>(p);
+    auto* q = static_cast<char*>(std::realloc(p, 33));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(q), before);
+
+    for (std::size_t size : {200u, 5000u, 70000u, 100u}) {
+        q = static_cast<char*>(std::realloc(q, size));
+        ASSERT_NE(q, nullptr);
+        EXPECT_EQ(std::memcmp(q, "0123456789", 10), 0) << size;
+        EXPECT_GE(malloc_usable_size(q), size);
+    }
+    EXPECT_EQ(std::realloc(q, 0), nullptr);
+}
+
+TEST(SGIMallocTest, AlignedAllocation) {
+    void* p = nullptr;
+    ASSERT_EQ(posix_memalign(&p, 64, 100), 0);
+    EXPECT_TRUE(is_aligned(p, 64));
+    std::free(p);
+
+    ASSERT_EQ(posix_memalign(&p, 4096, 10), 0);
+    EXPECT_TRUE(is_aligned(p, 4096));
+    std::free(p);
+
+    EXPECT_EQ(posix_memalign(&p, 3, 10), EINVAL);
+
+    void* q = std::aligned_alloc(256, 512);
+    ASSERT_NE(q, nullptr);
+    EXPECT_TRUE(is_aligned(q, 256));
+    std::free(q);
+
+    // 与 glibc 相同：aligned_alloc 接受小于指针大小的 2 的幂，memalign 把其他对齐向上取整
+    for (std::size_t alignment : {1u, 2u, 4u}) {
+        void* small = std::aligned_alloc(alignment, 24);
+        ASSERT_NE(small, nullptr) << alignment;
+        std::free(small);
+    }
+    errno = 0;
+    EXPECT_EQ(std::aligned_alloc(3, 24), nullptr);
+    EXPECT_EQ(errno, EINVAL);
+
+    void* m = memalign(2, 10);
+    ASSERT_NE(m, nullptr);
+    std::free(m);
+    m = memalign(100, 10);
+    ASSERT_NE(m, nullptr);
+    EXPECT_TRUE(is_aligned(m, 128));
+    std::free(m);
+}
+
+TEST(SGIMallocTest, OperatorNewForms) {
+    struct alignas(128) wide {
+        char data[200];
+    };
+    auto* w = new wide;
+    EXPECT_TRUE(is_aligned(w, 128));
+    delete w;
+
+    auto* array = new wide[3];
+    EXPECT_TRUE(is_aligned(array, 128));
+    delete[] array;
+
+    auto* s = new std::string(100, 'x');
+    EXPECT_EQ(s->size(), 100u);
+    delete s;
+
+    // 上游失败时在池锁内抛出异常，构造异常对象的分配不能再进入池
+    EXPECT_EQ(new (std::nothrow) char[SIZE_MAX / 4], nullptr);
+    EXPECT_THROW((void)::operator new(SIZE_MAX / 4), std::bad_alloc);
+}
+
+TEST(SGIMallocTest, CrossThreadFree) {
+    constexpr int COUNT = 20000;
+    std::vector<void*> pointers(COUNT);
+    std::thread producer([&] {
+        for (int i = 0; i < COUNT; ++i) {
+            pointers[i] = std::malloc(8 + i % 2000);
+        }
+    });
+    producer.join();
+
+    std::thread consumer([&] {
+        for (void* p : pointers) {
+            std::free(p);
+        }
+    });
+    consumer.join();
+
+    void* p = std::malloc(64);
+    EXPECT_NE(p, nullptr);
+    std::free(p);
+}
+
+#ifdef __GLIBC__
+TEST(SGIMallocTest, ForeignPointersGoToGlibc) {
+    // 不属于池的指针（例如注入前分配的）由 glibc 报告可用大小并释放
+    void* foreign = __libc_memalign(16, 100);
+    ASSERT_NE(foreign, nullptr);
+    EXPECT_GE(malloc_usable_size(foreign), 100u);
+    std::free(foreign);
+}
+#endif
+
+TEST(SGIMallocTest, ForkWhileAnotherThreadAllocates) {
+    std::atomic<bool> stop{false};
+    std::thread worker([&] {
+        // 大对象在池锁内向上游申请和归还，持锁时间长，fork 时锁被占用的概率高
+        while (!stop.load(std::memory_order_relaxed)) {
+            void* volatile p = std::malloc(1 << 20);
+            std::free(p);
+        }
+    });
+
+    // 另一个线程不断持有池锁时 fork，子进程中的分配不能死锁
+    for (int i = 0; i < 200; ++i) {
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            // volatile 避免编译器消去成对的 malloc/free
+            void* volatile p = std::malloc(64);
+            bool ok = p != nullptr;
+            std::free(p);
+            _exit(ok ? 0 : 1);
+        }
+        int status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        EXPECT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+
+    stop = true;
+    worker.join();
+}
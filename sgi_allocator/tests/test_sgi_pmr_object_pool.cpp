@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "../include/sgi_pmr_object_pool.hpp"
+#include <cstdint>
+#include <list>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace sgi_pmr;
+
+namespace {
+
+struct point {
+    double x;
+    double y;
+    point(double x_, double y_) : x(x_), y(y_) {}
+};
+
+// 构造函数按需抛出异常，用于检查 construct 的异常安全
+struct throwing {
+    static inline int live = 0;
+    explicit throwing(bool fail) {
+        if (fail) throw std::runtime_error("construct failed");
+        ++live;
+    }
+    ~throwing() { --live; }
+};
+
+struct alignas(64) cache_line {
+    int value;
+};
+
+} // namespace
+
+TEST(SGIObjectPoolTest, ConstructAndDestroy) {
+    object_pool<point> pool;
+
+    point* a = pool.construct(1.0, 2.0);
+    point* b = pool.construct(3.0, 4.0);
+    EXPECT_EQ(a->x, 1.0);
+    EXPECT_EQ(b->y, 4.0);
+    EXPECT_NE(a, b);
+
+    // 刚归还的对象最先被复用
+    pool.destroy(a);
+    point* c = pool.construct(5.0, 6.0);
+    EXPECT_EQ(c, a);
+
+    pool.destroy(b);
+    pool.destroy(c);
+    pool.destroy(nullptr);
+}
+
+TEST(SGIObjectPoolTest, ConstructFailureReturnsMemory) {
+    object_pool<throwing> pool;
+    throwing* ok = pool.construct(false);
+    pool.destroy(ok);
+
+    EXPECT_THROW(pool.construct(true), std::runtime_error);
+    EXPECT_EQ(throwing::live, 0);
+
+    // 失败时归还的内存被下一次构造复用
+    throwing* again = pool.construct(false);
+    EXPECT_EQ(again, ok);
+    pool.destroy(again);
+}
+
+TEST(SGIObjectPoolTest, SharesSizeClassWithResourcePath) {
+    object_pool<point> pool;
+    using pool_type = object_pool<point>::pool_type;
+
+    // 编译期选出的大小类与运行期查表一致，两条路径的对象可以互相归还
+    point* p = pool.allocate();
+    pool.pool().deallocate_impl(p, sizeof(point), alignof(point));
+    void* q = pool.pool().allocate_impl(sizeof(point), alignof(point));
+    EXPECT_EQ(q, p);
+    pool.deallocate(static_cast<point*>(q));
+
+    static_assert(pool_type::size_class_index(sizeof(point), alignof(point)) == 1);
+}
+
+TEST(SGIObjectPoolTest, OverAlignedObjects) {
+    object_pool<cache_line> pool;
+    std::vector<cache_line*> objects;
+    for (int i = 0; i < 100; ++i) {
+        objects.push_back(pool.construct(cache_line{i}));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(objects.back()) % 64, 0u);
+    }
+    for (cache_line* p : objects) {
+        pool.destroy(p);
+    }
+}
+
+TEST(SGIStaticPoolAllocatorTest, ListAndMapNodes) {
+    object_pool<int> pool;
+
+    std::list<int, static_pool_allocator<int>> lst(pool.get_allocator());
+    for (int i = 0; i < 1000; ++i) {
+        lst.push_back(i);
+    }
+    EXPECT_EQ(lst.size(), 1000u);
+    EXPECT_EQ(lst.back(), 999);
+
+    using map_allocator = static_pool_allocator<std::pair<const int, std::string>>;
+    std::map<int, std::string, std::less<int>, map_allocator> m(map_allocator(&pool.pool()));
+    for (int i = 0; i < 500; ++i) {
+        m.emplace(i, std::to_string(i));
+    }
+    EXPECT_EQ(m.at(250), "250");
+
+    // 节点容器与对象池共用内存块
+    EXPECT_EQ(lst.get_allocator(), pool.get_allocator());
+    lst.clear();
+    m.clear();
+    EXPECT_GT(pool.release(), 0u);
+}
+
+TEST(SGIStaticPoolAllocatorTest, ArraysAndLargeTypesFallBack) {
+    object_pool<char> pool;
+
+    // 数组和超过最大池化大小的类型走运行期路径
+    std::vector<int, static_pool_allocator<int>> vec(pool.get_allocator());
+    for (int i = 0; i < 10000; ++i) {
+        vec.push_back(i);
+    }
+    EXPECT_EQ(vec[9999], 9999);
+
+    struct big {
+        char data[1024];
+    };
+    static_pool_allocator<big> alloc(&pool.pool());
+    big* b = alloc.allocate(1);
+    b->data[1023] = 1;
+    alloc.deallocate(b, 1);
+}
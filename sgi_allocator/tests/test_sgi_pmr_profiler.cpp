@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "../include/sgi_pmr_profiler.hpp"
+#include "../include/sgi_pmr_allocator.hpp"
+#include "../include/sgi_pmr_object_pool.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace sgi_pmr;
+
+namespace {
+
+constexpr pool_options sampled_options{.sample_interval_bytes = 4096};
+using sampled_pool = basic_unsynchronized_pool_resource<sampled_options>;
+
+} // namespace
+
+// 调用栈中应出现的分配点，测试可执行文件导出符号后可以按名称找到；
+// noipa 防止编译器生成无法按名称符号化的特化副本
+[[gnu::noipa]] void sgi_profiler_test_allocation_site(std::pmr::memory_resource& mr, std::vector<void*>& out,
+                                                         std::size_t count, std::size_t bytes) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out.push_back(mr.allocate(bytes, 8));
+    }
+}
+
+TEST(SGIProfilerTest, DisabledSamplingRecordsNothing) {
+    heap_profiler::global().clear();
+    static_assert(sizeof(basic_sgi_pool_resource_base<sampled_options>) > sizeof(sgi_pool_resource_base));
+
+    unsynchronized_pool_resource mr;
+    std::vector<void*> pointers;
+    sgi_profiler_test_allocation_site(mr, pointers, 10000, 64);
+    EXPECT_EQ(heap_profiler::global().live_samples(), 0u);
+
+    for (void* p : pointers) {
+        mr.deallocate(p, 64, 8);
+    }
+}
+
+TEST(SGIProfilerTest, SamplesLiveAllocationsAndForgetsFreedOnes) {
+    heap_profiler::global().clear();
+    sampled_pool mr;
+
+    // 约 1 MB，平均应抽中约 256 次
+    std::vector<void*> pointers;
+    sgi_profiler_test_allocation_site(mr, pointers, 8192, 128);
+    std::size_t live = heap_profiler::global().live_samples();
+    EXPECT_GT(live, 100u);
+    EXPECT_LT(live, 500u);
+
+    // 按抽样概率放大后的估计接近真实的存活字节数
+    double estimate = 0;
+    for (const heap_profiler::stack_sample& stack : heap_profiler::global().snapshot()) {
+        estimate += stack.live_estimate;
+    }
+    EXPECT_GT(estimate, 8192 * 128 * 0.7);
+    EXPECT_LT(estimate, 8192 * 128 * 1.3);
+
+    for (void* p : pointers) {
+        mr.deallocate(p, 128, 8);
+    }
+    EXPECT_EQ(heap_profiler::global().live_samples(), 0u);
+}
+
+TEST(SGIProfilerTest, BulkAndChainPathsAreSampled) {
+    heap_profiler::global().clear();
+    basic_sgi_pool_resource_base<sampled_options> pool;
+
+    // 批量接口与逐个分配使用同一个采样计数
+    std::vector<void*> pointers(8192);
+    pool.allocate_bulk(128, 8, pointers.size(), pointers.data());
+    EXPECT_GT(heap_profiler::global().live_samples(), 100u);
+    pool.deallocate_bulk(pointers.data(), pointers.size(), 128, 8);
+    EXPECT_EQ(heap_profiler::global().live_samples(), 0u);
+
+    // 链式接口按大小类的字节数计
+    std::size_t index = pool.size_class_index(128);
+    void* head;
+    void* tail;
+    pool.allocate_chain(index, 8192, head, tail);
+    EXPECT_GT(heap_profiler::global().live_samples(), 100u);
+    pool.deallocate_chain(index, head, tail);
+    EXPECT_EQ(heap_profiler::global().live_samples(), 0u);
+}
+
+TEST(SGIProfilerTest, ObjectPoolIsSampled) {
+    heap_profiler::global().clear();
+    struct node {
+        char payload[128];
+    };
+    object_pool<node, sampled_options> pool;
+
+    // object_pool 绕过 allocate_impl 直接按大小类分配，同样参与采样
+    std::vector<node*> nodes;
+    for (int i = 0; i < 8192; ++i) {
+        nodes.push_back(pool.allocate());
+    }
+    EXPECT_GT(heap_profiler::global().live_samples(), 100u);
+
+    for (node* p : nodes) {
+        pool.deallocate(p);
+    }
+    EXPECT_EQ(heap_profiler::global().live_samples(), 0u);
+}
+
+TEST(SGIProfilerTest, LargeAllocationsAreAlwaysSampled) {
+    heap_profiler::global().clear();
+    sampled_pool mr;
+
+    // 远大于采样间隔的分配几乎必然被抽中
+    std::vector<void*> pointers;
+    sgi_profiler_test_allocation_site(mr, pointers, 4, 1 << 20);
+    EXPECT_EQ(heap_profiler::global().live_samples(), 4u);
+
+    std::vector<heap_profiler::stack_sample> stacks = heap_profiler::global().snapshot();
+    ASSERT_FALSE(stacks.empty());
+    EXPECT_EQ(stacks[0].live_bytes, 4u << 20);
+    EXPECT_EQ(stacks[0].total_count, 4u);
+
+    for (void* p : pointers) {
+        mr.deallocate(p, 1 << 20, 8);
+    }
+    stacks = heap_profiler::global().snapshot();
+    EXPECT_EQ(stacks[0].live_count, 0u);
+    EXPECT_EQ(stacks[0].total_count, 4u);
+}
+
+TEST(SGIProfilerTest, FoldedOutputNamesAllocationSite) {
+    heap_profiler::global().clear();
+    sampled_pool mr;
+
+    std::vector<void*> pointers;
+    sgi_profiler_test_allocation_site(mr, pointers, 4, 1 << 20);
+
+    std::ostringstream out;
+    heap_profiler::global().write_folded(out);
+    std::string folded = out.str();
+    EXPECT_NE(folded.find("sgi_profiler_test_allocation_site"), std::string::npos) << folded;
+
+    // 每行以空格和存活字节估计结尾
+    std::string first_line = folded.substr(0, folded.find('\n'));
+    EXPECT_GE(std::stoull(first_line.substr(first_line.rfind(' ') + 1)), 4u << 20);
+
+    for (void* p : pointers) {
+        mr.deallocate(p, 1 << 20, 8);
+    }
+    std::ostringstream empty;
+    heap_profiler::global().write_folded(empty);
+    EXPECT_TRUE(empty.str().empty());
+}
+
+TEST(SGIProfilerTest, PprofOutputHasHeapProfileLayout) {
+    heap_profiler::global().clear();
+    sampled_pool mr;
+
+    std::vector<void*> pointers;
+    sgi_profiler_test_allocation_site(mr, pointers, 2, 1 << 20);
+
+    std::ostringstream out;
+    heap_profiler::global().write_pprof(out);
+    std::string profile = out.str();
+    EXPECT_EQ(profile.rfind("heap profile: 2: 2097152 [2: 2097152] @ heap_v2/4096\n", 0), 0u) << profile;
+    EXPECT_NE(profile.find("\n2: 2097152 [2: 2097152] @ 0x"), std::string::npos);
+    EXPECT_NE(profile.find("\nMAPPED_LIBRARIES:\n"), std::string::npos);
+
+    for (void* p : pointers) {
+        mr.deallocate(p, 1 << 20, 8);
+    }
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include "../include/sgi_pmr_sharded.hpp"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <list>
+#include <algorithm>
+#include <cstring>
+
+using namespace sgi_pmr;
+
+TEST(SGIPageMapTest, SetAndClearRanges) {
+    detail::page_map<std::uint16_t> map;
+    alignas(detail::PAGE_SIZE) static char buffer[8 * detail::PAGE_SIZE];
+
+    // 未映射的页返回 0
+    EXPECT_EQ(map.get(buffer), 0);
+
+    map.set_range(buffer + detail::PAGE_SIZE, 3 * detail::PAGE_SIZE, 7);
+    EXPECT_EQ(map.get(buffer), 0);
+    EXPECT_EQ(map.get(buffer + detail::PAGE_SIZE), 7);
+    EXPECT_EQ(map.get(buffer + 4 * detail::PAGE_SIZE - 1), 7);
+    EXPECT_EQ(map.get(buffer + 4 * detail::PAGE_SIZE), 0);
+
+    map.clear_range(buffer + detail::PAGE_SIZE, 3 * detail::PAGE_SIZE);
+    EXPECT_EQ(map.get(buffer + 2 * detail::PAGE_SIZE), 0);
+}
+
+namespace {
+
+// 记录每次请求的大小和对齐
+class recording_resource : public std::pmr::memory_resource {
+public:
+    std::vector<std::pair<std::size_t, std::size_t>> requests;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        requests.emplace_back(bytes, alignment);
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+TEST(SGIPageMapTest, OwnerResourceRegistersOnlyChunks) {
+    recording_resource upstream;
+    detail::page_map<std::uint16_t> map;
+    detail::page_owner_resource<std::uint16_t> owner(&upstream, &map, 5, 64);
+
+    // 簿记数据原样转发，不按页取整也不登记
+    void* small = owner.allocate(48, 8);
+    ASSERT_EQ(upstream.requests.size(), 1u);
+    EXPECT_EQ(upstream.requests[0], std::make_pair(std::size_t{48}, std::size_t{8}));
+    EXPECT_EQ(map.get(small), 0);
+
+    // 内存块按页取整、按页对齐并登记
+    void* chunk = owner.allocate(320, 64);
+    ASSERT_EQ(upstream.requests.size(), 2u);
+    EXPECT_EQ(upstream.requests[1], std::make_pair(detail::PAGE_SIZE, detail::PAGE_SIZE));
+    EXPECT_EQ(map.get(chunk), 5);
+    EXPECT_EQ(map.get(static_cast<char*>(chunk) + detail::PAGE_SIZE - 1), 5);
+
+    owner.deallocate(chunk, 320, 64);
+    EXPECT_EQ(map.get(chunk), 0);
+    owner.deallocate(small, 48, 8);
+}
+
+TEST(SGIShardedPoolResourceTest, BasicAllocationDeallocation) {
+    sharded_pool_resource mr;
+    EXPECT_GE(mr.shard_count(), 1u);
+
+    // 分配和释放小内存
+    void* ptr1 = mr.allocate(16, 8);
+    EXPECT_NE(ptr1, nullptr);
+    EXPECT_LT(mr.shard_of(ptr1), mr.shard_count());
+    mr.deallocate(ptr1, 16, 8);
+
+    // 大内存不属于任何分片
+    void* ptr2 = mr.allocate(256, 8);
+    EXPECT_NE(ptr2, nullptr);
+    EXPECT_EQ(mr.shard_of(ptr2), mr.shard_count());
+    mr.deallocate(ptr2, 256, 8);
+}
+
+TEST(SGIShardedPoolResourceTest, FreesReturnToOwningShard) {
+    sharded_pool_resource mr(4, shard_selection::thread);
+    std::vector<void*> pointers;
+    std::atomic<int> phase{0};
+    void* reused = nullptr;
+
+    // 工作线程分配的对象由主线程释放，仍归还到原分片，工作线程随后能重用它们
+    std::thread worker([&]() {
+        for (int i = 0; i < 200; ++i) {
+            pointers.push_back(mr.allocate(32, 8));
+        }
+        phase = 1;
+        while (phase != 2) {
+            std::this_thread::yield();
+        }
+        reused = mr.allocate(32, 8);
+    });
+
+    while (phase != 1) {
+        std::this_thread::yield();
+    }
+    std::size_t owner = mr.shard_of(pointers.front());
+    for (void* ptr : pointers) {
+        EXPECT_EQ(mr.shard_of(ptr), owner);
+        mr.deallocate(ptr, 32, 8);
+    }
+    phase = 2;
+    worker.join();
+
+    EXPECT_EQ(mr.shard_of(reused), owner);
+    EXPECT_NE(std::find(pointers.begin(), pointers.end(), reused), pointers.end());
+    mr.deallocate(reused, 32, 8);
+}
+
+TEST(SGIShardedPoolResourceTest, ReleaseReturnsChunks) {
+    sharded_pool_resource mr(2, shard_selection::cpu);
+    {
+        std::pmr::list<int> lst(&mr);
+        for (int i = 0; i < 10000; ++i) {
+            lst.push_back(i);
+        }
+    }
+
+    EXPECT_GT(mr.release(), 0u);
+}
+
+TEST(SGIShardedPoolResourceTest, ThreadSafety) {
+    sharded_pool_resource mr(4, shard_selection::thread);
+    constexpr int num_threads = 8;
+    constexpr int allocations_per_thread = 1000;
+
+    std::vector<std::thread> threads;
+    std::atomic<int> success_count{0};
+
+    // 每个线程释放一部分其他线程分配的对象
+    std::vector<std::vector<std::pair<void*, std::size_t>>> handoff(num_threads);
+    std::atomic<int> ready{0};
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&, i]() {
+            std::mt19937 rng(i);
+            std::uniform_int_distribution<std::size_t> size_dist(8, 256);
+            std::vector<std::pair<void*, std::size_t>> allocations;
+
+            for (int j = 0; j < allocations_per_thread; ++j) {
+                std::size_t size = size_dist(rng);
+                void* ptr = mr.allocate(size, 8);
+                std::memset(ptr, i, size);
+                allocations.emplace_back(ptr, size);
+            }
+            success_count += allocations.size();
+
+            std::size_t half = allocations.size() / 2;
+            handoff[i].assign(allocations.begin() + half, allocations.end());
+            for (std::size_t j = 0; j < half; ++j) {
+                mr.deallocate(allocations[j].first, allocations[j].second, 8);
+            }
+
+            ++ready;
+            while (ready < num_threads) {
+                std::this_thread::yield();
+            }
+            for (const auto& alloc : handoff[(i + 1) % num_threads]) {
+                mr.deallocate(alloc.first, alloc.second, 8);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(success_count, num_threads * allocations_per_thread);
+}
+
+TEST(SGIShardedPoolResourceTest, OverAlignedContainers) {
+    sharded_pool_resource mr;
+
+    struct alignas(64) padded {
+        int value;
+    };
+
+    std::pmr::vector<padded> vec(&mr);
+    std::pmr::list<padded> lst(&mr);
+    for (int i = 0; i < 100; ++i) {
+        lst.push_back({i});
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&lst.back()) % 64, 0u);
+    }
+    EXPECT_EQ(lst.back().value, 99);
+}
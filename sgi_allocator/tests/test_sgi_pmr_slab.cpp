@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "../include/sgi_pmr_slab.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace sgi_pmr;
+
+TEST(SGISlabPoolTest, LowestFreeSlotIsReusedFirst) {
+    slab_pool_base pool;
+
+    std::vector<char*> objects;
+    for (int i = 0; i < 100; ++i) {
+        objects.push_back(static_cast<char*>(pool.allocate_impl(32, 8)));
+    }
+    // 新 slab 中的对象按地址连续分配
+    for (std::size_t i = 1; i < objects.size(); ++i) {
+        EXPECT_EQ(objects[i], objects[i - 1] + 32);
+    }
+
+    // 无论释放顺序如何，下一次分配总是地址最低的空闲槽位
+    pool.deallocate_impl(objects[70], 32, 8);
+    pool.deallocate_impl(objects[10], 32, 8);
+    pool.deallocate_impl(objects[40], 32, 8);
+    EXPECT_EQ(pool.allocate_impl(32, 8), objects[10]);
+    EXPECT_EQ(pool.allocate_impl(32, 8), objects[40]);
+    EXPECT_EQ(pool.allocate_impl(32, 8), objects[70]);
+    EXPECT_EQ(pool.allocate_impl(32, 8), objects[99] + 32);
+}
+
+TEST(SGISlabPoolTest, FillsSlabsAndReturnsEmptyOnes) {
+    slab_pool_base pool;
+    std::size_t index = sgi_pool_resource_base::size_class_index(128);
+    std::size_t per_slab = slab_pool_base::slots_per_slab(index);
+
+    std::vector<void*> objects;
+    for (std::size_t i = 0; i < per_slab * 3; ++i) {
+        void* p = pool.allocate_impl(128, 8);
+        std::memset(p, 0xCD, 128);
+        objects.push_back(p);
+    }
+    EXPECT_EQ(pool.slab_count(), 3u);
+
+    // 每个对象都在其 slab 之内且互不重叠
+    std::vector<void*> sorted = objects;
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(std::adjacent_find(sorted.begin(), sorted.end()), sorted.end());
+
+    // 释放前两个 slab 的全部对象后，release 归还它们
+    for (std::size_t i = 0; i < per_slab * 2; ++i) {
+        pool.deallocate_impl(objects[i], 128, 8);
+    }
+    EXPECT_EQ(pool.release(), 2 * slab_pool_base::SLAB_BYTES);
+    EXPECT_EQ(pool.slab_count(), 1u);
+
+    for (std::size_t i = per_slab * 2; i < objects.size(); ++i) {
+        pool.deallocate_impl(objects[i], 128, 8);
+    }
+}
+
+TEST(SGISlabPoolTest, AllSizeClassesAndAlignments) {
+    slab_pool_base pool;
+    std::mt19937 rng(7);
+    std::vector<std::pair<void*, std::pair<std::size_t, std::size_t>>> live;
+    const std::size_t alignments[] = {1, 8, 16, 32, 64};
+
+    for (int i = 0; i < 20000; ++i) {
+        if (!live.empty() && rng() % 3 == 0) {
+            std::size_t k = rng() % live.size();
+            pool.deallocate_impl(live[k].first, live[k].second.first, live[k].second.second);
+            live[k] = live.back();
+            live.pop_back();
+            continue;
+        }
+        std::size_t size = 1 + rng() % 200;
+        std::size_t alignment = alignments[rng() % 5];
+        void* p = pool.allocate_impl(size, alignment);
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % alignment, 0u);
+        std::memset(p, static_cast<int>(i), size);
+        live.push_back({p, {size, alignment}});
+    }
+
+    for (const auto& object : live) {
+        pool.deallocate_impl(object.first, object.second.first, object.second.second);
+    }
+    pool.release();
+    EXPECT_EQ(pool.slab_count(), 0u);
+}
+
+TEST(SGISlabPoolTest, ContainersOnResources) {
+    unsynchronized_slab_pool_resource unsync_mr;
+    synchronized_slab_pool_resource sync_mr;
+
+    std::pmr::list<int> a(&unsync_mr);
+    std::pmr::list<int> b(&sync_mr);
+    for (int i = 0; i < 10000; ++i) {
+        a.push_back(i);
+        b.push_front(i);
+    }
+    EXPECT_EQ(a.back(), 9999);
+    EXPECT_EQ(b.back(), 0);
+    EXPECT_GE(unsync_mr.slab_count(), 1u);
+}
+
+TEST(SGISlabPoolTest, SynchronizedThreadSafety) {
+    synchronized_slab_pool_resource mr;
+    constexpr int NUM_THREADS = 4;
+    std::atomic<int> errors{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&mr, &errors, t]() {
+            std::vector<int*> objects;
+            for (int i = 0; i < 2000; ++i) {
+                int* p = static_cast<int*>(mr.allocate(sizeof(int) * 4, alignof(int)));
+                p[0] = t;
+                objects.push_back(p);
+            }
+            for (int* p : objects) {
+                if (p[0] != t) ++errors;
+                mr.deallocate(p, sizeof(int) * 4, alignof(int));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(errors.load(), 0);
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include "../include/sgi_pmr_thread_cache.hpp"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <list>
+#include <algorithm>
+#include <cstring>
+
+using namespace sgi_pmr;
+
+TEST(SGIThreadCachedPoolResourceTest, BasicAllocationDeallocation) {
+    thread_cached_pool_resource mr;
+
+    // 分配和释放小内存
+    void* ptr1 = mr.allocate(16, 8);
+    EXPECT_NE(ptr1, nullptr);
+    mr.deallocate(ptr1, 16, 8);
+
+    // 分配和释放大内存
+    void* ptr2 = mr.allocate(256, 8);
+    EXPECT_NE(ptr2, nullptr);
+    mr.deallocate(ptr2, 256, 8);
+}
+
+TEST(SGIThreadCachedPoolResourceTest, CacheReusesFreedObject) {
+    thread_cached_pool_resource mr;
+
+    // 刚释放的对象应从线程缓存中被立即重用
+    void* ptr1 = mr.allocate(32, 8);
+    mr.deallocate(ptr1, 32, 8);
+    void* ptr2 = mr.allocate(32, 8);
+    EXPECT_EQ(ptr1, ptr2);
+    mr.deallocate(ptr2, 32, 8);
+}
+
+TEST(SGIThreadCachedPoolResourceTest, ExceedCacheLimit) {
+    thread_cached_pool_resource mr;
+    constexpr std::size_t count = thread_cached_pool_resource::MAX_CACHED_OBJECTS * 8;
+
+    // 大量释放会触发批量归还共享池，之后仍能正确分配
+    std::vector<void*> pointers;
+    for (std::size_t i = 0; i < count; ++i) {
+        void* ptr = mr.allocate(24, 8);
+        EXPECT_NE(ptr, nullptr);
+        pointers.push_back(ptr);
+    }
+
+    for (void* ptr : pointers) {
+        mr.deallocate(ptr, 24, 8);
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        pointers[i] = mr.allocate(24, 8);
+        EXPECT_NE(pointers[i], nullptr);
+    }
+
+    // 所有指针应互不相同
+    std::vector<void*> sorted = pointers;
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(std::adjacent_find(sorted.begin(), sorted.end()), sorted.end());
+
+    for (void* ptr : pointers) {
+        mr.deallocate(ptr, 24, 8);
+    }
+}
+
+TEST(SGIThreadCachedPoolResourceTest, ThreadExitReturnsCache) {
+    thread_cached_pool_resource mr;
+    void* from_thread = nullptr;
+
+    // 子线程释放的对象在线程退出时归还共享池，主线程可以再次分配到它
+    std::thread worker([&mr, &from_thread]() {
+        from_thread = mr.allocate(64, 8);
+        mr.deallocate(from_thread, 64, 8);
+    });
+    worker.join();
+
+    std::vector<void*> pointers;
+    bool found = false;
+    for (std::size_t i = 0; i < thread_cached_pool_resource::TRANSFER_BATCH * 2; ++i) {
+        void* ptr = mr.allocate(64, 8);
+        found = found || ptr == from_thread;
+        pointers.push_back(ptr);
+    }
+    EXPECT_TRUE(found);
+
+    for (void* ptr : pointers) {
+        mr.deallocate(ptr, 64, 8);
+    }
+}
+
+TEST(SGIThreadCachedPoolResourceTest, ThreadOutlivesResource) {
+    std::atomic<bool> destroyed{false};
+    std::atomic<bool> allocated{false};
+
+    // 资源先于线程销毁时，线程退出不应再访问它
+    auto* mr = new thread_cached_pool_resource;
+    std::thread worker([mr, &destroyed, &allocated]() {
+        void* ptr = mr->allocate(16, 8);
+        mr->deallocate(ptr, 16, 8);
+        allocated = true;
+        while (!destroyed) {
+            std::this_thread::yield();
+        }
+    });
+
+    while (!allocated) {
+        std::this_thread::yield();
+    }
+    delete mr;
+    destroyed = true;
+    worker.join();
+}
+
+TEST(SGIThreadCachedPoolResourceTest, ThreadSafety) {
+    thread_cached_pool_resource mr;
+    constexpr int num_threads = 4;
+    constexpr int allocations_per_thread = 1000;
+
+    std::vector<std::thread> threads;
+    std::atomic<int> success_count{0};
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&mr, &success_count, i]() {
+            std::mt19937 rng(i);
+            std::uniform_int_distribution<std::size_t> size_dist(8, 256);
+            std::vector<std::pair<void*, std::size_t>> allocations;
+
+            for (int j = 0; j < allocations_per_thread; ++j) {
+                std::size_t size = size_dist(rng);
+                void* ptr = mr.allocate(size, 8);
+                if (ptr != nullptr) {
+                    std::memset(ptr, i, size);
+                    allocations.emplace_back(ptr, size);
+                }
+            }
+
+            success_count += allocations.size();
+
+            for (const auto& alloc : allocations) {
+                mr.deallocate(alloc.first, alloc.second, 8);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(success_count, num_threads * allocations_per_thread);
+}
+
+TEST(SGIThreadCachedPoolResourceTest, ListWithPolymorphicAllocator) {
+    thread_cached_pool_resource mr;
+    std::pmr::list<int> lst(&mr);
+
+    for (int i = 0; i < 1000; ++i) {
+        lst.push_back(i);
+    }
+
+    EXPECT_EQ(lst.size(), 1000);
+    EXPECT_EQ(lst.front(), 0);
+    EXPECT_EQ(lst.back(), 999);
+}
+
+TEST(SGIThreadCachedPoolResourceTest, ReleaseFlushesLocalCache) {
+    thread_cached_pool_resource mr;
+
+    // 对象都在当前线程的缓存中，release 先归还缓存再归还空闲的内存块
+    std::vector<void*> pointers;
+    for (int i = 0; i < 2000; ++i) {
+        pointers.push_back(mr.allocate(48, 8));
+    }
+    for (void* ptr : pointers) {
+        mr.deallocate(ptr, 48, 8);
+    }
+
+    EXPECT_GT(mr.release(), 0u);
+
+    void* ptr = mr.allocate(48, 8);
+    EXPECT_NE(ptr, nullptr);
+    mr.deallocate(ptr, 48, 8);
+}
+
+TEST(SGIThreadCachedPoolResourceTest, StatsAggregateThreadCaches) {
+    basic_thread_cached_pool_resource<pool_options{.enable_stats = true}> mr;
+    std::size_t index = sgi_pool_resource_base::size_class_index(40);
+
+    // 每个线程缓存各自计数，快照时合计
+    auto work = [&mr]() {
+        std::vector<void*> pointers;
+        for (int i = 0; i < 100; ++i) {
+            pointers.push_back(mr.allocate(40, 8));
+        }
+        for (void* ptr : pointers) {
+            mr.deallocate(ptr, 40, 8);
+        }
+    };
+    std::thread worker(work);
+    worker.join();
+    work();
+
+    pool_stats stats = mr.stats();
+    EXPECT_EQ(stats.size_classes[index].allocations, 200u);
+    EXPECT_EQ(stats.size_classes[index].deallocations, 200u);
+    EXPECT_GT(stats.size_classes[index].refills, 0u);
+}
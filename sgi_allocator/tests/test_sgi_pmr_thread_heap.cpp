@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include "../include/sgi_pmr_thread_heap.hpp"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <deque>
+#include <algorithm>
+
+using namespace sgi_pmr;
+
+TEST(SGIThreadHeapPoolResourceTest, BasicAllocationDeallocation) {
+    thread_heap_pool_resource mr;
+
+    void* ptr1 = mr.allocate(16, 8);
+    EXPECT_NE(ptr1, nullptr);
+    EXPECT_TRUE(mr.owned_by_current_thread(ptr1));
+    mr.deallocate(ptr1, 16, 8);
+
+    // 大内存直接来自上游，不属于任何堆
+    void* ptr2 = mr.allocate(256, 8);
+    EXPECT_NE(ptr2, nullptr);
+    EXPECT_FALSE(mr.owned_by_current_thread(ptr2));
+    mr.deallocate(ptr2, 256, 8);
+
+    EXPECT_EQ(mr.heap_count(), 1u);
+}
+
+TEST(SGIThreadHeapPoolResourceTest, RemoteFreesReturnToOwningHeap) {
+    thread_heap_pool_resource mr;
+    std::vector<void*> pointers;
+    std::atomic<int> phase{0};
+    void* reused = nullptr;
+    bool reused_is_local = false;
+
+    // 工作线程分配的对象由主线程释放，进入工作线程堆的远程队列，
+    // 下次分配时整批拼接到空闲链表头部，因此首先被取回
+    std::thread worker([&]() {
+        for (int i = 0; i < 200; ++i) {
+            pointers.push_back(mr.allocate(32, 8));
+        }
+        phase = 1;
+        while (phase != 2) {
+            std::this_thread::yield();
+        }
+        reused = mr.allocate(32, 8);
+        reused_is_local = mr.owned_by_current_thread(reused);
+    });
+
+    while (phase != 1) {
+        std::this_thread::yield();
+    }
+    for (void* ptr : pointers) {
+        EXPECT_FALSE(mr.owned_by_current_thread(ptr));
+        mr.deallocate(ptr, 32, 8);
+    }
+    phase = 2;
+    worker.join();
+
+    EXPECT_TRUE(reused_is_local);
+    EXPECT_NE(std::find(pointers.begin(), pointers.end(), reused), pointers.end());
+    // 主线程只释放、从未分配，不需要自己的堆
+    EXPECT_EQ(mr.heap_count(), 1u);
+    mr.deallocate(reused, 32, 8);
+}
+
+TEST(SGIThreadHeapPoolResourceTest, HeapsAreReusedAfterThreadExit) {
+    thread_heap_pool_resource mr;
+
+    for (int i = 0; i < 5; ++i) {
+        std::thread worker([&mr]() {
+            std::pmr::list<int> lst(&mr);
+            for (int j = 0; j < 1000; ++j) {
+                lst.push_back(j);
+            }
+        });
+        worker.join();
+    }
+
+    EXPECT_EQ(mr.heap_count(), 1u);
+}
+
+TEST(SGIThreadHeapPoolResourceTest, ObjectsOutliveAllocatingThread) {
+    thread_heap_pool_resource mr;
+    std::vector<void*> pointers;
+
+    std::thread worker([&]() {
+        for (int i = 0; i < 10000; ++i) {
+            pointers.push_back(mr.allocate(64, 8));
+        }
+    });
+    worker.join();
+
+    // 分配线程已退出，释放进入无人使用的堆，release 取回后归还内存块
+    for (void* ptr : pointers) {
+        mr.deallocate(ptr, 64, 8);
+    }
+    EXPECT_GT(mr.release(), 0u);
+}
+
+TEST(SGIThreadHeapPoolResourceTest, ProducerConsumer) {
+    thread_heap_pool_resource mr;
+    constexpr int NUM_CONSUMERS = 3;
+    constexpr int MESSAGES = 20000;
+
+    struct message {
+        int sequence;
+        int checksum;
+    };
+
+    std::mutex queue_mutex;
+    std::deque<message*> queue;
+    std::atomic<bool> done{false};
+    std::atomic<int> consumed{0};
+    std::atomic<int> errors{0};
+
+    std::thread producer([&]() {
+        for (int i = 0; i < MESSAGES; ++i) {
+            auto* m = static_cast<message*>(mr.allocate(sizeof(message), alignof(message)));
+            m->sequence = i;
+            m->checksum = ~i;
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            queue.push_back(m);
+        }
+        done = true;
+    });
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < NUM_CONSUMERS; ++c) {
+        consumers.emplace_back([&]() {
+            while (true) {
+                message* m = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex);
+                    if (!queue.empty()) {
+                        m = queue.front();
+                        queue.pop_front();
+                    }
+                }
+                if (!m) {
+                    if (done && consumed == MESSAGES) break;
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (m->checksum != ~m->sequence) {
+                    ++errors;
+                }
+                mr.deallocate(m, sizeof(message), alignof(message));
+                ++consumed;
+            }
+        });
+    }
+
+    producer.join();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    EXPECT_EQ(consumed.load(), MESSAGES);
+    EXPECT_EQ(errors.load(), 0);
+}
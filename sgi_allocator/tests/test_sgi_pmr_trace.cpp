@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "../include/sgi_pmr_trace.hpp"
+#include "../include/sgi_pmr_allocator.hpp"
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace sgi_pmr;
+
+namespace {
+
+// 测试用的临时轨迹文件，析构时删除
+struct temp_trace {
+    std::string path;
+
+    explicit temp_trace(const char* name)
+        : path(std::string(::testing::TempDir()) + name) {}
+    ~temp_trace() { std::remove(path.c_str()); }
+};
+
+} // namespace
+
+TEST(SGITraceTest, RecordsAllocationsAndDeallocations) {
+    temp_trace file("sgi_trace_basic.bin");
+    {
+        synchronized_pool_resource pool;
+        recording_resource recorder(file.path, &pool);
+
+        void* a = recorder.allocate(24, 8);
+        void* b = recorder.allocate(1000, 64);
+        recorder.deallocate(a, 24, 8);
+        recorder.deallocate(b, 1000, 64);
+        EXPECT_EQ(recorder.record_count(), 4u);
+    }
+
+    std::vector<trace_record> trace = read_trace(file.path);
+    ASSERT_EQ(trace.size(), 4u);
+
+    EXPECT_EQ(trace[0].op, trace_op::allocate);
+    EXPECT_EQ(trace[0].size, 24u);
+    EXPECT_EQ(trace[0].alignment(), 8u);
+    EXPECT_EQ(trace[1].size, 1000u);
+    EXPECT_EQ(trace[1].alignment(), 64u);
+
+    // 同一对象的分配和释放编号相同
+    EXPECT_EQ(trace[2].op, trace_op::deallocate);
+    EXPECT_EQ(trace[2].id, trace[0].id);
+    EXPECT_EQ(trace[3].id, trace[1].id);
+    EXPECT_NE(trace[0].id, trace[1].id);
+
+    // 时间戳单调不减
+    for (std::size_t i = 1; i < trace.size(); ++i) {
+        EXPECT_LE(trace[i - 1].timestamp_ns, trace[i].timestamp_ns);
+    }
+}
+
+TEST(SGITraceTest, RecordsContainerTrafficAcrossBuffers) {
+    temp_trace file("sgi_trace_list.bin");
+    std::size_t recorded;
+    {
+        recording_resource recorder(file.path);
+        {
+            std::pmr::list<int> lst(&recorder);
+            for (int i = 0; i < 5000; ++i) {
+                lst.push_back(i);
+            }
+        }
+        recorded = recorder.record_count();
+    }
+
+    // 超过缓冲大小的记录全部写入文件
+    std::vector<trace_record> trace = read_trace(file.path);
+    EXPECT_EQ(trace.size(), recorded);
+    EXPECT_EQ(trace.size(), 10000u);
+}
+
+TEST(SGITraceTest, DistinguishesThreads) {
+    temp_trace file("sgi_trace_threads.bin");
+    {
+        recording_resource recorder(file.path);
+        recorder.deallocate(recorder.allocate(16, 8), 16, 8);
+        std::thread worker([&recorder]() {
+            recorder.deallocate(recorder.allocate(32, 8), 32, 8);
+        });
+        worker.join();
+    }
+
+    std::vector<trace_record> trace = read_trace(file.path);
+    ASSERT_EQ(trace.size(), 4u);
+    EXPECT_EQ(trace[0].thread, trace[1].thread);
+    EXPECT_EQ(trace[2].thread, trace[3].thread);
+    EXPECT_NE(trace[0].thread, trace[2].thread);
+}
+
+TEST(SGITraceTest, RejectsInvalidFiles) {
+    temp_trace file("sgi_trace_invalid.bin");
+    {
+        std::ofstream out(file.path, std::ios::binary);
+        out << "not a trace";
+    }
+
+    EXPECT_THROW(read_trace(file.path), std::runtime_error);
+    EXPECT_THROW(read_trace(file.path + ".missing"), std::runtime_error);
+}